@@ -0,0 +1,268 @@
+/*
+********************************************************************************
+*
+*      File             : fant-arc.c
+*      Tested Platforms : Linux-OS
+*      Description      : Writing and reading of indexed output archives
+*                         (layout see fant-arc.h). Archives are read via
+*                         mmap(), so records can be used without copying.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "fant.h"
+#include "fant-arc.h"
+
+#define ARC_BUFFER  (4*1048576)    /* stdio buffer for sequential writing */
+
+static int compare_entries(const void*, const void*);
+static int sort_entries(FANT_ARC*);
+
+/*=====================================================================*/
+
+FANT_ARC *fant_arc_create(const char *path)
+{
+	FANT_ARC       *arc;
+	FANT_ARC_HEADER head;
+
+	if ( (arc = (FANT_ARC*)calloc(1, sizeof(FANT_ARC))) == NULL)
+		return NULL;
+	if ( (arc->fp = fopen(path, "w")) == NULL)
+	{
+		free(arc);
+		return NULL;
+	}
+	setvbuf(arc->fp, NULL, _IOFBF, ARC_BUFFER);
+	memset(&head, 0, sizeof(head));
+	memcpy(head.magic, FANT_ARC_MAGIC, 4);
+	head.version = FANT_ARC_VERSION;
+	if (fwrite(&head, sizeof(head), 1, arc->fp) != 1)
+	{
+		fclose(arc->fp);
+		free(arc);
+		return NULL;
+	}
+	arc->size = sizeof(head);
+	return arc;
+}
+
+/***  append the samples of one utterance  ***/
+int fant_arc_append(FANT_ARC *arc, const char *name, short *buf, long no_samples,
+	FANT_RESULT *res)
+{
+	FANT_ARC_ENTRY *entry;
+
+	if (arc->fp == NULL)
+		return FANT_ERR_PARAM;
+	if (arc->no_entries == arc->max_entries)
+	{
+		if ( (entry = (FANT_ARC_ENTRY*)realloc(arc->entries,
+			(size_t)(arc->max_entries+1024)*sizeof(FANT_ARC_ENTRY))) == NULL)
+			return FANT_ERR_MEMORY;
+		arc->entries = entry;
+		arc->max_entries += 1024;
+	}
+	entry = &arc->entries[arc->no_entries];
+	memset(entry, 0, sizeof(FANT_ARC_ENTRY));
+	if ( (entry->name = strdup(name)) == NULL)
+		return FANT_ERR_MEMORY;
+	entry->index.offset = arc->size;
+	entry->index.no_samples = no_samples;
+	entry->index.name_len = (int32_t) strlen(name);
+	if (res != NULL)
+	{
+		entry->index.speech_level = res->speech_level;
+		entry->index.noise_level = res->noise_level;
+		entry->index.snr = res->snr;
+		entry->index.overload = res->overload;
+		entry->index.start = res->noise_short ? -1 : res->start;
+	}
+	if (fwrite(buf, sizeof(short), (size_t)no_samples, arc->fp) != (size_t)no_samples)
+	{
+		free(entry->name);
+		return FANT_ERR_IO;
+	}
+	arc->size += (int64_t)no_samples * (int64_t)sizeof(short);
+	arc->no_entries++;
+	return FANT_OK;
+}
+
+/***  write the index and close the archive, the handle is freed  ***/
+int fant_arc_close(FANT_ARC *arc)
+{
+	FANT_ARC_TRAILER trailer;
+	long             i;
+	int              ret = FANT_OK;
+
+	if (arc->fp != NULL)
+	{
+		for (i=0 ; i<arc->no_entries ; i++)
+		{
+			if ( (fwrite(&arc->entries[i].index, sizeof(FANT_ARC_INDEX), 1, arc->fp) != 1) ||
+			     (fwrite(arc->entries[i].name, 1, (size_t)arc->entries[i].index.name_len, arc->fp)
+				!= (size_t)arc->entries[i].index.name_len) )
+				ret = FANT_ERR_IO;
+		}
+		memset(&trailer, 0, sizeof(trailer));
+		memcpy(trailer.magic, FANT_ARC_INDEX_MAGIC, 4);
+		trailer.no_records = (int32_t) arc->no_entries;
+		trailer.index_offset = arc->size;
+		if (fwrite(&trailer, sizeof(trailer), 1, arc->fp) != 1)
+			ret = FANT_ERR_IO;
+		if (fclose(arc->fp) != 0)
+			ret = FANT_ERR_IO;
+		arc->fp = NULL;
+	}
+	fant_arc_free(arc);
+	return ret;
+}
+
+/*=====================================================================*/
+
+/***  map an archive and read its index, NULL if it is not valid  ***/
+FANT_ARC *fant_arc_open(const char *path)
+{
+	FANT_ARC        *arc;
+	FANT_ARC_HEADER  head;
+	FANT_ARC_TRAILER trailer;
+	struct stat      st;
+	char            *p, *end, *name;
+	long             i;
+	int              fd;
+
+	if ( (fd = open(path, O_RDONLY)) < 0)
+		return NULL;
+	if ( (fstat(fd, &st) < 0) || ((size_t)st.st_size < sizeof(head)+sizeof(trailer)) ||
+	     ( (arc = (FANT_ARC*)calloc(1, sizeof(FANT_ARC))) == NULL) )
+	{
+		close(fd);
+		return NULL;
+	}
+	arc->data_size = (size_t)st.st_size;
+	arc->data = mmap(NULL, arc->data_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (arc->data == MAP_FAILED)
+	{
+		free(arc);
+		return NULL;
+	}
+
+	memcpy(&head, arc->data, sizeof(head));
+	memcpy(&trailer, arc->data+arc->data_size-sizeof(trailer), sizeof(trailer));
+	if ( (memcmp(head.magic, FANT_ARC_MAGIC, 4) != 0) || (head.version != FANT_ARC_VERSION) ||
+	     (memcmp(trailer.magic, FANT_ARC_INDEX_MAGIC, 4) != 0) || (trailer.no_records < 0) ||
+	     (trailer.index_offset < (int64_t)sizeof(head)) ||
+	     (trailer.index_offset > (int64_t)(arc->data_size-sizeof(trailer))) )
+	{
+		fant_arc_free(arc);
+		return NULL;
+	}
+
+	/* index entries and a pool of terminated names */
+	end = arc->data + arc->data_size - sizeof(trailer);
+	arc->no_entries = arc->max_entries = trailer.no_records;
+	if ( ( (arc->entries = (FANT_ARC_ENTRY*)calloc((size_t)arc->no_entries+1, sizeof(FANT_ARC_ENTRY))) == NULL) ||
+	     ( (arc->names = (char*)malloc((size_t)(end-arc->data-trailer.index_offset)+1)) == NULL) )
+	{
+		fant_arc_free(arc);
+		return NULL;
+	}
+	p = arc->data + trailer.index_offset;
+	name = arc->names;
+	for (i=0 ; i<arc->no_entries ; i++)
+	{
+		if (p+sizeof(FANT_ARC_INDEX) > end)
+			break;
+		memcpy(&arc->entries[i].index, p, sizeof(FANT_ARC_INDEX));
+		p += sizeof(FANT_ARC_INDEX);
+		if ( (arc->entries[i].index.name_len < 0) || (p+arc->entries[i].index.name_len > end) ||
+		     (arc->entries[i].index.offset < (int64_t)sizeof(head)) || (arc->entries[i].index.no_samples < 0) ||
+		     (arc->entries[i].index.offset + arc->entries[i].index.no_samples*(int64_t)sizeof(short) > trailer.index_offset) )
+			break;
+		memcpy(name, p, (size_t)arc->entries[i].index.name_len);
+		arc->entries[i].name = name;
+		name += arc->entries[i].index.name_len;
+		*name++ = '\0';
+		p += arc->entries[i].index.name_len;
+	}
+	if ( (i < arc->no_entries) || (sort_entries(arc) != FANT_OK) )
+	{
+		fant_arc_free(arc);
+		return NULL;
+	}
+	return arc;
+}
+
+FANT_ARC_ENTRY *fant_arc_find(FANT_ARC *arc, const char *name)
+{
+	FANT_ARC_ENTRY   key, *pkey = &key, **found;
+
+	if (arc->sorted == NULL)
+		return NULL;
+	key.name = (char*) name;
+	found = (FANT_ARC_ENTRY**)bsearch(&pkey, arc->sorted, (size_t)arc->no_entries,
+		sizeof(FANT_ARC_ENTRY*), compare_entries);
+	return (found == NULL) ? NULL : *found;
+}
+
+const short *fant_arc_samples(FANT_ARC *arc, FANT_ARC_ENTRY *entry)
+{
+	if (arc->data == NULL)
+		return NULL;
+	return (const short*)(arc->data + entry->index.offset);
+}
+
+void fant_arc_free(FANT_ARC *arc)
+{
+	long i;
+
+	if (arc == NULL)
+		return;
+	if (arc->fp != NULL)
+		fclose(arc->fp);
+	if (arc->data != NULL)
+		munmap(arc->data, arc->data_size);
+	else
+	{
+		for (i=0 ; i<arc->no_entries ; i++)
+			free(arc->entries[i].name);
+	}
+	free(arc->entries);
+	free(arc->sorted);
+	free(arc->names);
+	free(arc);
+}
+
+/*=====================================================================*/
+
+static int sort_entries(FANT_ARC *arc)
+{
+	long i;
+
+	if ( (arc->sorted = (FANT_ARC_ENTRY**)calloc((size_t)arc->no_entries+1, sizeof(FANT_ARC_ENTRY*))) == NULL)
+		return FANT_ERR_MEMORY;
+	for (i=0 ; i<arc->no_entries ; i++)
+		arc->sorted[i] = &arc->entries[i];
+	qsort(arc->sorted, (size_t)arc->no_entries, sizeof(FANT_ARC_ENTRY*), compare_entries);
+	return FANT_OK;
+}
+
+static int compare_entries(const void *a, const void *b)
+{
+	return strcmp((*(FANT_ARC_ENTRY**)a)->name, (*(FANT_ARC_ENTRY**)b)->name);
+}
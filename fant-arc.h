@@ -0,0 +1,91 @@
+/*
+  ============================================================================
+   File: FANT-ARC.H
+  ============================================================================
+
+                   INDEXED OUTPUT ARCHIVE OF FILTER_ADD_NOISE
+
+   Instead of one small file per utterance all outputs of a run are
+   appended to an archive (option --archive). Layout, host byte order:
+
+     FANT_ARC_HEADER
+     samples (raw SHORT) of all records, one after the other
+     index: per record a FANT_ARC_INDEX followed by name_len bytes of the
+            name (not terminated)
+     FANT_ARC_TRAILER
+
+   The archive is written in one sequential pass; the index is kept in
+   memory and appended by fant_arc_close(). fant_arc_open() maps an
+   archive read-only, fant_arc_find() looks up a record by name and
+   fant_arc_samples() returns a pointer to its samples in the mapping.
+
+   History:
+   p1a  18-10-26   basic version
+
+  ============================================================================
+*/
+#ifndef FANT_ARC_defined
+#define FANT_ARC_defined 100
+
+#include <stdio.h>
+#include <stdint.h>
+#include "fant.h"
+
+#define FANT_ARC_MAGIC        "FNTA"
+#define FANT_ARC_INDEX_MAGIC  "FNTX"
+#define FANT_ARC_VERSION      1
+
+typedef struct {
+	char     magic[4];      /* FANT_ARC_MAGIC */
+	int32_t  version;
+} FANT_ARC_HEADER;
+
+typedef struct {
+	int64_t  offset;        /* of the 1st sample in the archive (bytes) */
+	int64_t  no_samples;
+	float    speech_level;  /* S before normalization */
+	float    noise_level;
+	float    snr;
+	float    overload;      /* max. amplitude before overload correction */
+	int32_t  start;         /* 1st noise sample, -1 if noise too short */
+	int32_t  name_len;
+} FANT_ARC_INDEX;
+
+typedef struct {
+	char     magic[4];      /* FANT_ARC_INDEX_MAGIC */
+	int32_t  no_records;
+	int64_t  index_offset;
+} FANT_ARC_TRAILER;
+
+/* record of an archive in memory */
+typedef struct {
+	char           *name;
+	FANT_ARC_INDEX  index;
+} FANT_ARC_ENTRY;
+
+typedef struct {
+	FILE            *fp;           /* archive being written */
+	int64_t          size;         /* bytes written so far */
+	char            *data;         /* mapping of an archive being read */
+	size_t           data_size;
+	FANT_ARC_ENTRY  *entries;      /* in the order of the archive */
+	long             no_entries;
+	long             max_entries;
+	FANT_ARC_ENTRY **sorted;       /* by name, for fant_arc_find() */
+	char            *names;        /* names of a mapped archive */
+} FANT_ARC;
+
+/* writing */
+FANT_ARC *fant_arc_create(const char *path);
+int  fant_arc_append(FANT_ARC *arc, const char *name, short *buf, long no_samples,
+                     FANT_RESULT *res);
+int  fant_arc_close(FANT_ARC *arc);
+
+/* reading */
+FANT_ARC *fant_arc_open(const char *path);
+FANT_ARC_ENTRY *fant_arc_find(FANT_ARC *arc, const char *name);
+const short *fant_arc_samples(FANT_ARC *arc, FANT_ARC_ENTRY *entry);
+void fant_arc_free(FANT_ARC *arc);
+
+#endif /* FANT_ARC_defined */
+/* ......................... End of FANT-ARC.H ......................... */
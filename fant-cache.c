@@ -0,0 +1,275 @@
+/*
+********************************************************************************
+*
+*      File             : fant-cache.c
+*      Tested Platforms : Linux-OS
+*      Description      : Persistent cache of the speech levels and of the
+*                         filtered speech of clean speech files (see
+*                         fant-cache.h). The records of the cache file are
+*                         indexed in a hash table when the cache is opened;
+*                         a truncated record at the end (e.g. after a crash)
+*                         is overwritten by the next record.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*      p1b  18-10-26                   files keyed by their canonical path
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "fant.h"
+#include "fant-cache.h"
+
+#define PAD8(n)  (((n)+7) & ~(int64_t)7)
+#define MAX_NAME 65536
+
+static const char *canonical_name(const char*, char*);
+static unsigned long hash_key(const char*, int, int);
+static int  insert_entry(FANT_CACHE*, FANT_CACHE_ENTRY*);
+static int  rehash(FANT_CACHE*, long);
+
+/*=====================================================================*/
+
+/***  open (or create) a cache file and index its records  ***/
+FANT_CACHE *fant_cache_open(const char *path)
+{
+	FANT_CACHE       *cache;
+	FANT_CACHE_ENTRY  entry;
+	struct stat       st;
+	int64_t           pos, end;
+
+	if ( (cache = (FANT_CACHE*)calloc(1, sizeof(FANT_CACHE))) == NULL)
+		return NULL;
+	if ( (cache->fd = open(path, O_RDWR | O_CREAT, 0644)) < 0)
+	{
+		free(cache);
+		return NULL;
+	}
+	if ( (fstat(cache->fd, &st) < 0) || (rehash(cache, 1024) != FANT_OK) )
+	{
+		close(cache->fd);
+		free(cache->hash);
+		free(cache);
+		return NULL;
+	}
+
+	for (pos=0 ; pos+(int64_t)sizeof(FANT_CACHE_RECORD) <= (int64_t)st.st_size ; pos=end)
+	{
+		if (pread(cache->fd, &entry.rec, sizeof(FANT_CACHE_RECORD), (off_t)pos) != sizeof(FANT_CACHE_RECORD))
+			break;
+		if ( (memcmp(entry.rec.magic, FANT_CACHE_MAGIC, 4) != 0) || (entry.rec.name_len < 0) ||
+		     (entry.rec.name_len > MAX_NAME) || (entry.rec.no_samples < 0) )
+			break;
+		entry.offset = pos + sizeof(FANT_CACHE_RECORD) + PAD8(entry.rec.name_len);
+		end = entry.offset + PAD8(entry.rec.no_samples*(int64_t)sizeof(float));
+		if (end > (int64_t)st.st_size)
+			break;
+		if ( (entry.name = (char*)malloc((size_t)entry.rec.name_len+1)) == NULL)
+			break;
+		if (pread(cache->fd, entry.name, (size_t)entry.rec.name_len, (off_t)(pos+sizeof(FANT_CACHE_RECORD)))
+			!= entry.rec.name_len)
+		{
+			free(entry.name);
+			break;
+		}
+		entry.name[entry.rec.name_len] = '\0';
+		if (insert_entry(cache, &entry) != FANT_OK)
+		{
+			free(entry.name);
+			break;
+		}
+	}
+	cache->size = pos;
+	return cache;
+}
+
+/***  entry of an unchanged speech file or NULL  ***/
+FANT_CACHE_ENTRY *fant_cache_find(FANT_CACHE *cache, const char *name,
+	int mode, int filter_type)
+{
+	FANT_CACHE_ENTRY *entry;
+	struct stat       st;
+	char              path[PATH_MAX];
+	long              i;
+
+	name = canonical_name(name, path);
+	mode &= FANT_CACHE_MODE;
+	for (i=cache->hash[hash_key(name, mode, filter_type) % cache->hash_size] ; i>=0 ; i=entry->next)
+	{
+		entry = &cache->entries[i];
+		if ( (entry->rec.mode != mode) || (entry->rec.filter_type != filter_type) || (strcmp(entry->name, name) != 0) )
+			continue;
+		/* the latest record of a file decides */
+		if ( (stat(name, &st) == 0) && (entry->rec.size == (int64_t)st.st_size) &&
+		     (entry->rec.mtime_sec == (int64_t)st.st_mtim.tv_sec) &&
+		     (entry->rec.mtime_nsec == (int64_t)st.st_mtim.tv_nsec) )
+		{
+			cache->no_hits++;
+			return entry;
+		}
+		break;
+	}
+	cache->no_misses++;
+	return NULL;
+}
+
+/***  read the filtered samples of an entry  ***/
+int fant_cache_samples(FANT_CACHE *cache, FANT_CACHE_ENTRY *entry, float *buf)
+{
+	size_t n = (size_t)entry->rec.no_samples*sizeof(float);
+
+	if (pread(cache->fd, buf, n, (off_t)entry->offset) != (ssize_t)n)
+		return FANT_ERR_IO;
+	return FANT_OK;
+}
+
+/***  append a record for the current state of a speech file  ***/
+int fant_cache_add(FANT_CACHE *cache, const char *name, int mode, int filter_type,
+	double speech_level, double activity, float *samples, long no_samples)
+{
+	FANT_CACHE_ENTRY entry;
+	struct stat      st;
+	static const char zeros[8] = { 0 };
+	char             path[PATH_MAX];
+	int64_t          pos = cache->size;
+	size_t           n;
+
+	name = canonical_name(name, path);
+	if (stat(name, &st) < 0)
+		return FANT_ERR_IO;
+	memset(&entry, 0, sizeof(entry));
+	memcpy(entry.rec.magic, FANT_CACHE_MAGIC, 4);
+	entry.rec.name_len = (int32_t) strlen(name);
+	entry.rec.size = (int64_t) st.st_size;
+	entry.rec.mtime_sec = (int64_t) st.st_mtim.tv_sec;
+	entry.rec.mtime_nsec = (int64_t) st.st_mtim.tv_nsec;
+	entry.rec.mode = mode & FANT_CACHE_MODE;
+	entry.rec.filter_type = filter_type;
+	entry.rec.speech_level = speech_level;
+	entry.rec.activity = activity;
+	entry.rec.no_samples = (samples != NULL) ? no_samples : 0;
+	if (entry.rec.name_len > MAX_NAME)
+		return FANT_ERR_PARAM;
+
+	if (pwrite(cache->fd, &entry.rec, sizeof(entry.rec), (off_t)pos) != sizeof(entry.rec))
+		return FANT_ERR_IO;
+	pos += sizeof(entry.rec);
+	n = (size_t)entry.rec.name_len;
+	if ( (pwrite(cache->fd, name, n, (off_t)pos) != (ssize_t)n) ||
+	     (pwrite(cache->fd, zeros, (size_t)(PAD8(n)-n), (off_t)(pos+n)) != (ssize_t)(PAD8(n)-n)) )
+		return FANT_ERR_IO;
+	pos += PAD8(n);
+	entry.offset = pos;
+	n = (size_t)entry.rec.no_samples*sizeof(float);
+	if ( (pwrite(cache->fd, samples, n, (off_t)pos) != (ssize_t)n) ||
+	     (pwrite(cache->fd, zeros, (size_t)(PAD8(n)-n), (off_t)(pos+n)) != (ssize_t)(PAD8(n)-n)) )
+		return FANT_ERR_IO;
+	pos += PAD8(n);
+
+	if ( (entry.name = strdup(name)) == NULL)
+		return FANT_ERR_MEMORY;
+	if (insert_entry(cache, &entry) != FANT_OK)
+	{
+		free(entry.name);
+		return FANT_ERR_MEMORY;
+	}
+	cache->size = pos;
+	return FANT_OK;
+}
+
+/***  absolute path without ".", ".." and links (the name if it fails),  ***/
+/*    so that "./a.raw" and "a.raw" are the same entry                     */
+static const char *canonical_name(const char *name, char *path)
+{
+	return (realpath(name, path) != NULL) ? path : name;
+}
+
+/***  close the cache file, the handle is freed  ***/
+int fant_cache_close(FANT_CACHE *cache)
+{
+	long i;
+	int  ret = FANT_OK;
+
+	if (cache == NULL)
+		return FANT_OK;
+	/* remove a truncated record at the end */
+	if (ftruncate(cache->fd, (off_t)cache->size) != 0)
+		ret = FANT_ERR_IO;
+	if (close(cache->fd) != 0)
+		ret = FANT_ERR_IO;
+	for (i=0 ; i<cache->no_entries ; i++)
+		free(cache->entries[i].name);
+	free(cache->entries);
+	free(cache->hash);
+	free(cache);
+	return ret;
+}
+
+/*=====================================================================*/
+
+static unsigned long hash_key(const char *name, int mode, int filter_type)
+{
+	unsigned long h = 2166136261UL;
+
+	while (*name)
+		h = (h ^ (unsigned char)*name++) * 16777619UL;
+	h = (h ^ (unsigned long)mode) * 16777619UL;
+	return (h ^ (unsigned long)filter_type) * 16777619UL;
+}
+
+/* new entries are put in front of their chain and replace older ones */
+static int insert_entry(FANT_CACHE *cache, FANT_CACHE_ENTRY *entry)
+{
+	FANT_CACHE_ENTRY *entries;
+	unsigned long     h;
+
+	if (cache->no_entries == cache->max_entries)
+	{
+		if ( (entries = (FANT_CACHE_ENTRY*)realloc(cache->entries,
+			(size_t)(cache->max_entries+4096)*sizeof(FANT_CACHE_ENTRY))) == NULL)
+			return FANT_ERR_MEMORY;
+		cache->entries = entries;
+		cache->max_entries += 4096;
+	}
+	if ( (cache->no_entries >= 2*cache->hash_size) && (rehash(cache, 4*cache->hash_size) != FANT_OK) )
+		return FANT_ERR_MEMORY;
+	h = hash_key(entry->name, entry->rec.mode, entry->rec.filter_type) % cache->hash_size;
+	entry->next = cache->hash[h];
+	cache->entries[cache->no_entries] = *entry;
+	cache->hash[h] = cache->no_entries++;
+	return FANT_OK;
+}
+
+static int rehash(FANT_CACHE *cache, long size)
+{
+	long         *hash, i;
+	unsigned long h;
+
+	if ( (hash = (long*)malloc((size_t)size*sizeof(long))) == NULL)
+		return FANT_ERR_MEMORY;
+	for (i=0 ; i<size ; i++)
+		hash[i] = -1;
+	/* in the order of the file, so later entries stay in front */
+	for (i=0 ; i<cache->no_entries ; i++)
+	{
+		h = hash_key(cache->entries[i].name, cache->entries[i].rec.mode, cache->entries[i].rec.filter_type) % size;
+		cache->entries[i].next = hash[h];
+		hash[h] = i;
+	}
+	free(cache->hash);
+	cache->hash = hash;
+	cache->hash_size = size;
+	return FANT_OK;
+}
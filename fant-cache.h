@@ -0,0 +1,86 @@
+/*
+  ============================================================================
+   File: FANT-CACHE.H
+  ============================================================================
+
+                  PERSISTENT ANALYSIS CACHE OF CLEAN SPEECH FILES
+
+   The speech level S and the activity factor of a speech file depend only
+   on the file, on the measurement mode (-u, -m, -d) and on the byte order
+   of raw files (--big-endian). They are kept in a cache file (option
+   --cache) together with, optionally, the speech filtered with an output
+   filter, so that repeated runs over the same corpus go straight to the
+   noise adding.
+   A file is identified by its canonical path (realpath()), size and
+   modification time.
+
+   The cache file is a sequence of records (host byte order): a
+   FANT_CACHE_RECORD, the name padded to a multiple of 8 bytes and
+   no_samples float samples padded to a multiple of 8 bytes. New records
+   are appended; a later record for the same key replaces an earlier one.
+
+   History:
+   p1a  18-10-26   basic version
+   p1b  18-10-26   32 and 48 kHz data
+   p1c  18-10-26   files keyed by their canonical path
+   p1d  18-10-26   byte order of raw files in the key
+
+  ============================================================================
+*/
+#ifndef FANT_CACHE_defined
+#define FANT_CACHE_defined 100
+
+#include <stdint.h>
+#include "fant.h"
+
+#define FANT_CACHE_MAGIC  "FNTC"
+
+/* raw files read as big endian (no FANT_PARAMS mode) */
+#define FANT_CACHE_BIG_ENDIAN  0x10000
+
+/* mode bits that change the measurement of S */
+#define FANT_CACHE_MODE   (SAMP16K | SAMP32K | SAMP48K | SNR_4khz | SNR_8khz | DC_COMP | A_WEIGHT | \
+                           FANT_CACHE_BIG_ENDIAN)
+
+typedef struct {
+	char     magic[4];      /* FANT_CACHE_MAGIC */
+	int32_t  name_len;
+	int64_t  size;          /* of the speech file */
+	int64_t  mtime_sec;
+	int64_t  mtime_nsec;
+	int32_t  mode;          /* measurement mode (FANT_CACHE_MODE bits) */
+	int32_t  filter_type;   /* of the stored samples, NONE if none */
+	double   speech_level;
+	double   activity;
+	int64_t  no_samples;    /* filtered samples following the name */
+} FANT_CACHE_RECORD;
+
+typedef struct {
+	char              *name;
+	FANT_CACHE_RECORD  rec;
+	int64_t            offset;  /* of the samples in the cache file */
+	long               next;    /* next entry of the hash chain or -1 */
+} FANT_CACHE_ENTRY;
+
+typedef struct {
+	int                fd;
+	int64_t            size;        /* end of the valid records */
+	FANT_CACHE_ENTRY  *entries;
+	long               no_entries;
+	long               max_entries;
+	long              *hash;        /* 1st entry per hash value or -1 */
+	long               hash_size;
+	long               no_hits;
+	long               no_misses;
+} FANT_CACHE;
+
+FANT_CACHE *fant_cache_open(const char *path);
+FANT_CACHE_ENTRY *fant_cache_find(FANT_CACHE *cache, const char *name,
+                                  int mode, int filter_type);
+int  fant_cache_samples(FANT_CACHE *cache, FANT_CACHE_ENTRY *entry, float *buf);
+int  fant_cache_add(FANT_CACHE *cache, const char *name, int mode, int filter_type,
+                    double speech_level, double activity, float *samples, long no_samples);
+int  fant_cache_close(FANT_CACHE *cache);
+
+#endif /* FANT_CACHE_defined */
+/* ........................ End of FANT-CACHE.H ........................ */
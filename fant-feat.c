@@ -0,0 +1,225 @@
+/*
+********************************************************************************
+*
+*      File             : fant-feat.c
+*      Tested Platforms : Linux-OS
+*      Description      : Log-mel filterbank features with a built-in real
+*                         FFT and the feature file (see fant-feat.h).
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "fant.h"
+#include "fant-feat.h"
+
+static double mel(double f);
+static void   frame_power(FANT_FEAT*, const float*);
+
+/*=====================================================================*/
+
+FANT_FEAT *fant_feat_init(int rate, double win_ms, double hop_ms, int no_bins)
+{
+	FANT_FEAT *feat;
+	long       m, k, i, j, bits;
+	double     mel_max, lower, center, upper, f, w;
+
+	if ( (feat = (FANT_FEAT*)calloc(1, sizeof(FANT_FEAT))) == NULL)
+		return NULL;
+	feat->rate = rate;
+	feat->win = (long)(win_ms * rate / 1000. + 0.5);
+	feat->hop = (long)(hop_ms * rate / 1000. + 0.5);
+	feat->no_bins = no_bins;
+	for (feat->nfft = 4 ; feat->nfft < feat->win ; feat->nfft *= 2)
+		;
+	m = feat->nfft / 2;
+	if ( (feat->win < 2) || (feat->hop < 1) || (no_bins < 1) || (no_bins > m) ||
+	     ( (feat->window = (float*)calloc((size_t)feat->win, sizeof(float))) == NULL) ||
+	     ( (feat->cos = (float*)calloc((size_t)m+1, sizeof(float))) == NULL) ||
+	     ( (feat->sin = (float*)calloc((size_t)m+1, sizeof(float))) == NULL) ||
+	     ( (feat->bitrev = (long*)calloc((size_t)m, sizeof(long))) == NULL) ||
+	     ( (feat->first = (int*)calloc((size_t)no_bins, sizeof(int))) == NULL) ||
+	     ( (feat->last = (int*)calloc((size_t)no_bins, sizeof(int))) == NULL) ||
+	     ( (feat->weight = (float*)calloc((size_t)no_bins*(m+1), sizeof(float))) == NULL) ||
+	     ( (feat->re = (float*)calloc((size_t)m, sizeof(float))) == NULL) ||
+	     ( (feat->im = (float*)calloc((size_t)m, sizeof(float))) == NULL) ||
+	     ( (feat->power = (float*)calloc((size_t)m+1, sizeof(float))) == NULL) )
+	{
+		fant_feat_free(feat);
+		return NULL;
+	}
+
+	for (i=0 ; i<feat->win ; i++)
+		feat->window[i] = (float)(0.54 - 0.46 * cos(2. * M_PI * (double)i / (double)(feat->win - 1)));
+	for (k=0 ; k<=m ; k++)
+	{
+		feat->cos[k] = (float)cos(2. * M_PI * (double)k / (double)feat->nfft);
+		feat->sin[k] = (float)sin(2. * M_PI * (double)k / (double)feat->nfft);
+	}
+	for (bits=0 ; (1L << bits) < m ; bits++)
+		;
+	for (i=0 ; i<m ; i++)
+	{
+		for (j=0, k=0 ; j<bits ; j++)
+			k |= ( (i >> j) & 1) << (bits - 1 - j);
+		feat->bitrev[i] = k;
+	}
+
+	/* triangular filters on the spectral lines k*rate/nfft */
+	mel_max = mel(rate / 2.);
+	for (j=0 ; j<no_bins ; j++)
+	{
+		lower = mel_max * (double)j / (double)(no_bins + 1);
+		center = mel_max * (double)(j + 1) / (double)(no_bins + 1);
+		upper = mel_max * (double)(j + 2) / (double)(no_bins + 1);
+		feat->first[j] = (int)m + 1;
+		feat->last[j] = -1;
+		for (k=0 ; k<=m ; k++)
+		{
+			f = mel((double)k * rate / (double)feat->nfft);
+			w = (f <= center) ? (f - lower) / (center - lower) : (upper - f) / (upper - center);
+			if (w <= 0.)
+				continue;
+			feat->weight[j*(m+1) + k] = (float)w;
+			if (k < feat->first[j])
+				feat->first[j] = (int)k;
+			feat->last[j] = (int)k;
+		}
+	}
+	return feat;
+}
+
+void fant_feat_free(FANT_FEAT *feat)
+{
+	if (feat == NULL)
+		return;
+	free(feat->window);
+	free(feat->cos);
+	free(feat->sin);
+	free(feat->bitrev);
+	free(feat->first);
+	free(feat->last);
+	free(feat->weight);
+	free(feat->re);
+	free(feat->im);
+	free(feat->power);
+	free(feat);
+}
+
+static double mel(double f)
+{
+	return 2595. * log10(1. + f / 700.);
+}
+
+/*=====================================================================*/
+
+long fant_feat_frames(FANT_FEAT *feat, long no_samples)
+{
+	return (no_samples < feat->win) ? 0 : 1 + (no_samples - feat->win) / feat->hop;
+}
+
+long fant_feat_compute(FANT_FEAT *feat, const float *signal, long no_samples, float *out)
+{
+	long   no_frames = fant_feat_frames(feat, no_samples), t, k, m = feat->nfft / 2;
+	int    j;
+	double e;
+
+	for (t=0 ; t<no_frames ; t++)
+	{
+		frame_power(feat, &signal[t * feat->hop]);
+		for (j=0 ; j<feat->no_bins ; j++)
+		{
+			e = 0.;
+			for (k=feat->first[j] ; k<=feat->last[j] ; k++)
+				e += (double)feat->weight[j*(m+1) + k] * feat->power[k];
+			out[t * feat->no_bins + j] = (float)log( (e > FANT_FEAT_FLOOR) ? e : FANT_FEAT_FLOOR);
+		}
+	}
+	return no_frames;
+}
+
+/***  power spectrum of one windowed frame  ***/
+static void frame_power(FANT_FEAT *feat, const float *x)
+{
+	float *re = feat->re, *im = feat->im;
+	float  tr, ti, wr, wi, er, ei, or, oi;
+	long   m = feat->nfft / 2, len, half, step, i, j, a, b, k;
+
+	/* even samples as real, odd ones as imaginary part, bit reversed */
+	for (i=0 ; i<m ; i++)
+	{
+		re[feat->bitrev[i]] = (2*i < feat->win) ? x[2*i] * feat->window[2*i] : 0.f;
+		im[feat->bitrev[i]] = (2*i+1 < feat->win) ? x[2*i+1] * feat->window[2*i+1] : 0.f;
+	}
+
+	/* complex FFT of m points, W_len^j = W_nfft^(j*nfft/len) */
+	for (len=2 ; len<=m ; len*=2)
+	{
+		half = len / 2;
+		step = feat->nfft / len;
+		for (i=0 ; i<m ; i+=len)
+		{
+			for (j=0 ; j<half ; j++)
+			{
+				wr = feat->cos[j*step];
+				wi = -feat->sin[j*step];
+				a = i + j;
+				b = a + half;
+				tr = re[b] * wr - im[b] * wi;
+				ti = re[b] * wi + im[b] * wr;
+				re[b] = re[a] - tr;
+				im[b] = im[a] - ti;
+				re[a] += tr;
+				im[a] += ti;
+			}
+		}
+	}
+
+	/* split into the spectra of the even and odd samples, X = E + W^k O */
+	for (k=0 ; k<=m ; k++)
+	{
+		a = k % m;
+		b = (m - k) % m;
+		er = 0.5f * (re[a] + re[b]);
+		ei = 0.5f * (im[a] - im[b]);
+		or = 0.5f * (im[a] + im[b]);
+		oi = -0.5f * (re[a] - re[b]);
+		tr = er + feat->cos[k] * or + feat->sin[k] * oi;
+		ti = ei + feat->cos[k] * oi - feat->sin[k] * or;
+		feat->power[k] = tr * tr + ti * ti;
+	}
+}
+
+/*=====================================================================*/
+
+int fant_feat_write(FANT_FEAT *feat, const char *path, const float *out, long no_frames)
+{
+	FANT_FEAT_HEADER header;
+	FILE            *fp;
+	int              ret = FANT_OK;
+
+	if ( (fp = fopen(path, "wb")) == NULL)
+		return FANT_ERR_IO;
+	memcpy(header.magic, FANT_FEAT_MAGIC, 4);
+	header.no_frames = (int32_t)no_frames;
+	header.no_bins = feat->no_bins;
+	header.win = (int32_t)feat->win;
+	header.hop = (int32_t)feat->hop;
+	header.rate = feat->rate;
+	if ( (fwrite(&header, sizeof(header), 1, fp) != 1) ||
+	     (fwrite(out, sizeof(float), (size_t)(no_frames * feat->no_bins), fp) != (size_t)(no_frames * feat->no_bins)) )
+		ret = FANT_ERR_IO;
+	if (fclose(fp) != 0)
+		ret = FANT_ERR_IO;
+	return ret;
+}
@@ -0,0 +1,78 @@
+/*
+  ============================================================================
+   File: FANT-FEAT.H
+  ============================================================================
+
+              LOG-MEL FILTERBANK FEATURES OF THE OUTPUT (--features)
+
+   Framed log-mel filterbank features computed from the processed signal
+   while it is still in the cache, instead of writing the waveform and
+   reading it back for the feature extraction:
+
+     frame      win samples every hop samples (frames that fit entirely)
+     window     Hamming
+     spectrum   power |X(k)|^2 of a real FFT of nfft points (the next power
+                of 2 >= win, zero padded), k = 0 ... nfft/2
+     filterbank no_bins triangular filters equally spaced on the mel scale
+                mel(f) = 2595 log10(1 + f/700) from 0 Hz to rate/2
+     log        natural logarithm of the filter energy (at least
+                FANT_FEAT_FLOOR)
+
+   The signal is in the range -1 ... 1 (as the 16 bit output divided by
+   32768). The real FFT is computed as a complex FFT of nfft/2 points
+   (radix 2) of the even and odd samples, split afterwards.
+
+   Feature file (--features), host byte order:
+
+     FANT_FEAT_HEADER
+     no_frames x no_bins float, frame by frame
+
+   A FANT_FEAT holds the work buffers of one frame and can therefore be
+   used by one thread at a time only.
+
+   History:
+   p1a  18-10-26   basic version
+
+  ============================================================================
+*/
+#ifndef FANT_FEAT_defined
+#define FANT_FEAT_defined 100
+
+#include <stdint.h>
+#include "fant.h"
+
+#define FANT_FEAT_MAGIC  "FNTF"
+#define FANT_FEAT_FLOOR  1e-10
+
+typedef struct {
+	char     magic[4];      /* FANT_FEAT_MAGIC */
+	int32_t  no_frames;
+	int32_t  no_bins;
+	int32_t  win;           /* frame length in samples */
+	int32_t  hop;           /* frame shift in samples */
+	int32_t  rate;          /* sampling frequency */
+} FANT_FEAT_HEADER;
+
+typedef struct {
+	int     rate;
+	long    win, hop, nfft;
+	int     no_bins;
+	float  *window;         /* win */
+	float  *cos, *sin;      /* twiddle factors of nfft points (nfft/2) */
+	long   *bitrev;         /* bit reversal of nfft/2 points */
+	int    *first, *last;   /* spectral lines of each filter */
+	float  *weight;         /* no_bins x (nfft/2+1) */
+	float  *re, *im;        /* work buffers (nfft/2) */
+	float  *power;          /* nfft/2+1 */
+} FANT_FEAT;
+
+/* NULL if the memory is exhausted or the parameters are invalid */
+FANT_FEAT *fant_feat_init(int rate, double win_ms, double hop_ms, int no_bins);
+long fant_feat_frames(FANT_FEAT *feat, long no_samples);
+/* features of fant_feat_frames() frames in "out", returns their number */
+long fant_feat_compute(FANT_FEAT *feat, const float *signal, long no_samples, float *out);
+int  fant_feat_write(FANT_FEAT *feat, const char *path, const float *out, long no_frames);
+void fant_feat_free(FANT_FEAT *feat);
+
+#endif /* FANT_FEAT_defined */
+/* ........................ End of FANT-FEAT.H ......................... */
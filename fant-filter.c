@@ -0,0 +1,164 @@
+/*
+********************************************************************************
+*
+*      File             : fant-filter.c
+*      Tested Platforms : Linux-OS
+*      Description      : Filters of filter_samples() as chains of STL
+*                         kernels that are run tile by tile (see
+*                         fant-filter.h).
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*      p1b  18-10-26                   MIRS at 48 kHz, 3:1 downsampling
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fant.h"
+#include "fant-perf.h"
+#include "fant-kern.h"
+#include "fant-tables.h"
+#include "fant-filter.h"
+
+#define P341_FILTER_SHIFT  125
+#define IRS_FILTER_SHIFT    75
+#define MIRS_FILTER_SHIFT  182
+#define P341_16K_FILTER_SHIFT  296
+#define MIRS_48K_FILTER_SHIFT  256
+
+static int  add_fir(FANT_FILTER*, int);
+static int  add_iir(FANT_FILTER*);
+static long run_stage(FANT_STAGE*, long, float*, float*);
+
+/*=====================================================================*/
+
+FANT_FILTER *fant_filter_init(int type)
+{
+	FANT_FILTER *f;
+	int          ok;
+
+	if ( (f = (FANT_FILTER*)calloc(1, sizeof(FANT_FILTER))) == NULL)
+		return NULL;
+	f->type = type;
+	f->down = 1;
+	switch(type)
+	{
+	  case G712:
+		ok = add_iir(f);
+		break;
+	  case P341:
+		f->shift = P341_FILTER_SHIFT;
+		ok = add_fir(f, FANT_T_HP_8KHZ);
+		break;
+	  case IRS:
+		f->shift = IRS_FILTER_SHIFT;
+		ok = add_fir(f, FANT_T_IRS_8KHZ);
+		break;
+	  case MIRS:  /* at 16 kHz */
+		f->shift = MIRS_FILTER_SHIFT;
+		ok = add_fir(f, FANT_T_UP_1_TO_2) && add_fir(f, FANT_T_MOD_IRS_16KHZ) && add_fir(f, FANT_T_DOWN_2_TO_1);
+		break;
+	  case G712_16K:  /* at 8 kHz */
+		f->down = 2;
+		ok = add_fir(f, FANT_T_DOWN_2_TO_1) && add_iir(f);
+		break;
+	  case P341_16K:
+		f->shift = P341_16K_FILTER_SHIFT;
+		ok = add_fir(f, FANT_T_P341_16KHZ);
+		break;
+	  case MIRS_48K:
+		f->shift = MIRS_48K_FILTER_SHIFT;
+		ok = add_fir(f, FANT_T_MOD_IRS_48KHZ);
+		break;
+	  case DOWN:
+		f->down = 2;
+		ok = add_fir(f, FANT_T_DOWN_2_TO_1);
+		break;
+	  case DOWN_3:
+		f->down = 3;
+		ok = add_fir(f, FANT_T_DOWN_3_TO_1);
+		break;
+	  default:
+		ok = 0;
+	}
+	/* up to twice the input samples between the stages */
+	if (ok && (f->no_stages > 1))
+	{
+		ok = ( (f->tile[0] = (float*)calloc((size_t)2*FANT_TILE+1, sizeof(float))) != NULL) &&
+		     ( (f->tile[1] = (float*)calloc((size_t)2*FANT_TILE+1, sizeof(float))) != NULL);
+	}
+	if (!ok)
+	{
+		fant_filter_free(f);
+		return NULL;
+	}
+	return f;
+}
+
+static int add_fir(FANT_FILTER *f, int table)
+{
+	return (f->stage[f->no_stages++].fir = fant_fir_init(table)) != NULL;
+}
+
+static int add_iir(FANT_FILTER *f)
+{
+	return (f->stage[f->no_stages++].iir = iir_G712_8khz_init()) != NULL;
+}
+
+void fant_filter_free(FANT_FILTER *f)
+{
+	int k;
+
+	if (f == NULL)
+		return;
+	for (k=0 ; k<f->no_stages ; k++)
+	{
+		if (f->stage[k].fir != NULL)
+			fant_fir_free(f->stage[k].fir);
+		if (f->stage[k].iir != NULL)
+			cascade_iir_free(f->stage[k].iir);
+	}
+	free(f->tile[0]);
+	free(f->tile[1]);
+	free(f);
+}
+
+/*=====================================================================*/
+
+long fant_filter_run(FANT_FILTER *f, long lseg, float *x, float *y)
+{
+	float *in, *out;
+	long   i, len, no = 0;
+	int    k;
+
+	for (i=0 ; i<lseg ; i+=FANT_TILE)
+	{
+		len = (lseg-i < FANT_TILE) ? lseg-i : FANT_TILE;
+		in = &x[i];
+		for (k=0 ; k<f->no_stages ; k++)
+		{
+			out = (k == f->no_stages-1) ? &y[no] : f->tile[k & 1];
+			len = run_stage(&f->stage[k], len, in, out);
+			in = out;
+		}
+		no += len;
+	}
+	return no;
+}
+
+static long run_stage(FANT_STAGE *s, long len, float *in, float *out)
+{
+	long no;
+
+	if (s->fir != NULL)
+		FANT_PERF_CALL(FANT_K_HQ, len, no = fant_kernels.fir(len, in, s->fir, out));
+	else
+		FANT_PERF_CALL(FANT_K_IIR, len, no = cascade_iir_kernel(len, in, s->iir, out));
+	return no;
+}
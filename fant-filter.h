@@ -0,0 +1,58 @@
+/*
+  ============================================================================
+   File: FANT-FILTER.H
+  ============================================================================
+
+                    TILED FILTER CHAINS OF LIBFANT
+
+   A filter of filter_samples() as a chain of up to FANT_MAX_STAGES
+   kernels of the ITU-T STL (e.g. MIRS: upsampling, modified IRS and
+   downsampling). fant_filter_run() pushes the signal through the chain in
+   tiles of FANT_TILE input samples: every tile runs through all stages
+   before the next one is read, so the samples between the stages are
+   held in tile sized buffers that stay in the cache, whatever the length
+   of the signal. The stages keep their state (k0, T) from tile to tile
+   as for any segment-wise call of the STL kernels, the outputs are
+   therefore identical to filtering the whole signal stage by stage.
+
+   A chain can be run on consecutive segments of a signal; it is not
+   thread safe, every thread needs its own chain.
+
+   History:
+   p1a  18-10-26   basic version
+   p1b  18-10-26   MIRS at 48 kHz, 3:1 downsampling
+
+  ============================================================================
+*/
+#ifndef FANT_FILTER_defined
+#define FANT_FILTER_defined 100
+
+#include "firflt.h"
+#include "iirflt.h"
+
+#define FANT_TILE        1024  /* input samples, 8 kB between the MIRS stages */
+#define FANT_MAX_STAGES  3
+
+/* one stage: FIR or IIR kernel */
+typedef struct {
+	SCD_FIR     *fir;
+	CASCADE_IIR *iir;
+} FANT_STAGE;
+
+typedef struct {
+	int         type;        /* filter_samples() type */
+	int         no_stages;
+	FANT_STAGE  stage[FANT_MAX_STAGES];
+	long        shift;       /* delay of the filter in output samples */
+	long        down;        /* input samples per output sample (1, 2 or 3) */
+	float      *tile[2];     /* samples between the stages */
+} FANT_FILTER;
+
+/* NULL if the memory is exhausted or the type is unknown */
+FANT_FILTER *fant_filter_init(int type);
+/* lseg samples of x, returns the number of outputs in y */
+long fant_filter_run(FANT_FILTER *filter, long lseg, float *x, float *y);
+void fant_filter_free(FANT_FILTER *filter);
+
+#endif /* FANT_FILTER_defined */
+/* ....................... End of FANT-FILTER.H ........................ */
@@ -0,0 +1,427 @@
+/*
+********************************************************************************
+*
+*      File             : fant-io.c
+*      Tested Platforms : Linux-OS
+*      Description      : Read-ahead of speech files and write-behind of the
+*                         processed outputs for the batch mode (see fant-io.h).
+*                         A pool of threads serves one queue of read and
+*                         write jobs; the processing thread only waits if
+*                         the next input is not yet loaded or if "depth"
+*                         outputs are still pending.
+*                         io_uring is not used to keep the library free of
+*                         dependencies beyond pthreads.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*      p1b  18-10-26                   tracked outputs
+*      p1c  18-10-26                   trace spans of reads and writes
+*      p1d  18-10-26                   WAV inputs and outputs (fant-wav.c)
+*      p1e  18-10-26                   float outputs
+*      p1f  18-10-26                   outputs of a tag tracked together
+*      p1g  18-10-26                   byte order of raw inputs
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "fant.h"
+#include "fant-io.h"
+#include "fant-trace.h"
+#include "fant-wav.h"
+
+static void *io_thread(void*);
+static void  do_job(FANT_IO_JOB*);
+static FANT_IO_JOB *new_job(int, const char*);
+static void  free_job(FANT_IO_JOB*);
+static void  queue_job(FANT_IO*, FANT_IO_JOB*);
+static int   queue_write(FANT_IO*, FANT_IO_JOB*);
+
+/*=====================================================================*/
+
+FANT_IO *fant_io_init(int no_threads, int depth)
+{
+	FANT_IO *io;
+	int      i;
+
+	if ( (no_threads < 1) || (depth < 1) )
+		return NULL;
+	if ( (io = (FANT_IO*)calloc(1, sizeof(FANT_IO))) == NULL)
+		return NULL;
+	if ( (io->threads = (pthread_t*)calloc((size_t)no_threads, sizeof(pthread_t))) == NULL)
+	{
+		free(io);
+		return NULL;
+	}
+	io->depth = depth;
+	io->error = FANT_OK;
+	pthread_mutex_init(&io->lock, NULL);
+	pthread_cond_init(&io->work, NULL);
+	pthread_cond_init(&io->done, NULL);
+	for (i=0 ; i<no_threads ; i++)
+	{
+		if (pthread_create(&io->threads[i], NULL, io_thread, io) != 0)
+			break;
+		io->no_threads++;
+	}
+	if (io->no_threads == 0)
+	{
+		fant_io_free(io);
+		return NULL;
+	}
+	return io;
+}
+
+void fant_io_free(FANT_IO *io)
+{
+	FANT_IO_JOB *job;
+	int          i;
+
+	if (io == NULL)
+		return;
+	pthread_mutex_lock(&io->lock);
+	io->stop = 1;
+	pthread_cond_broadcast(&io->work);
+	pthread_mutex_unlock(&io->lock);
+	for (i=0 ; i<io->no_threads ; i++)
+		pthread_join(io->threads[i], NULL);
+
+	/* the threads finish all queued jobs before they stop,
+	   only reads not fetched by fant_io_next() are left     */
+	while ( (job = io->first_read) != NULL)
+	{
+		io->first_read = job->next_read;
+		free_job(job);
+	}
+	while ( (job = io->first_written) != NULL)
+	{
+		io->first_written = job->next_written;
+		free_job(job);
+	}
+	pthread_cond_destroy(&io->done);
+	pthread_cond_destroy(&io->work);
+	pthread_mutex_destroy(&io->lock);
+	free(io->error_name);
+	free(io->threads);
+	free(io);
+}
+
+/***  queue reading of the next speech file  ***/
+int fant_io_read(FANT_IO *io, const char *name)
+{
+	FANT_IO_JOB *job;
+
+	if ( (job = new_job(FANT_IO_READ, name)) == NULL)
+		return FANT_ERR_MEMORY;
+	job->rate = io->rate;
+	job->big_endian = io->big_endian;
+	pthread_mutex_lock(&io->lock);
+	if (io->last_read == NULL)
+		io->first_read = job;
+	else
+		io->last_read->next_read = job;
+	io->last_read = job;
+	queue_job(io, job);
+	pthread_mutex_unlock(&io->lock);
+	return FANT_OK;
+}
+
+/***  wait for the samples of the oldest queued speech file  ***/
+short *fant_io_next(FANT_IO *io, long *no_samples, int *status)
+{
+	FANT_IO_JOB *job;
+	short       *buf;
+
+	pthread_mutex_lock(&io->lock);
+	if ( (job = io->first_read) == NULL)
+	{
+		pthread_mutex_unlock(&io->lock);
+		*status = FANT_ERR_PARAM;
+		return NULL;
+	}
+	while (!job->done)
+		pthread_cond_wait(&io->done, &io->lock);
+	if ( (io->first_read = job->next_read) == NULL)
+		io->last_read = NULL;
+	pthread_mutex_unlock(&io->lock);
+
+	*status = job->status;
+	*no_samples = job->no_samples;
+	buf = job->buf;
+	job->buf = NULL;
+	free_job(job);
+	return buf;
+}
+
+/***  queue writing of an output, the buffer is freed when written  ***/
+int fant_io_write(FANT_IO *io, const char *name, short *buf, long no_samples)
+{
+	return fant_io_write_tag(io, name, buf, no_samples, -1);
+}
+
+/***  as fant_io_write(), the output is tracked if "tag" is not negative  ***/
+int fant_io_write_tag(FANT_IO *io, const char *name, short *buf, long no_samples, long tag)
+{
+	FANT_IO_JOB *job;
+
+	if ( (job = new_job(FANT_IO_WRITE, name)) == NULL)
+	{
+		free(buf);
+		return FANT_ERR_MEMORY;
+	}
+	job->buf = buf;
+	job->no_samples = no_samples;
+	job->tag = tag;
+	return queue_write(io, job);
+}
+
+/***  as fant_io_write_tag(), float samples that are not quantized  ***/
+int fant_io_write_float(FANT_IO *io, const char *name, float *buf, long no_samples, long tag)
+{
+	FANT_IO_JOB *job;
+
+	if ( (job = new_job(FANT_IO_WRITE, name)) == NULL)
+	{
+		free(buf);
+		return FANT_ERR_MEMORY;
+	}
+	job->fbuf = buf;
+	job->no_samples = no_samples;
+	job->tag = tag;
+	return queue_write(io, job);
+}
+
+/***  next tracked output that has been written (see status) or NULL,  ***/
+/*    the last one of its tag once all outputs of the tag are written     */
+FANT_IO_JOB *fant_io_written(FANT_IO *io)
+{
+	FANT_IO_JOB *job, *other, **p;
+	int          status = FANT_OK;
+
+	pthread_mutex_lock(&io->lock);
+	for (job = io->first_written ; job != NULL ; job = job->next_written)
+	{
+		for (other = io->first_written ; other != NULL ; other = other->next_written)
+			if ( (other->tag == job->tag) && !other->done)
+				break;
+		if (other == NULL)
+			break;
+	}
+	if (job != NULL)
+	{
+		/* the outputs of the tag leave the list, the last one is returned */
+		other = NULL;
+		io->last_written = NULL;
+		p = &io->first_written;
+		while (*p != NULL)
+		{
+			if ( (*p)->tag != job->tag)
+			{
+				io->last_written = *p;
+				p = &(*p)->next_written;
+				continue;
+			}
+			if (status == FANT_OK)
+				status = (*p)->status;
+			if (other != NULL)
+				free_job(other);
+			other = *p;
+			*p = other->next_written;
+		}
+		job = other;
+		job->status = status;
+		job->next_written = NULL;
+	}
+	pthread_mutex_unlock(&io->lock);
+	return job;
+}
+
+void fant_io_release(FANT_IO_JOB *job)
+{
+	free_job(job);
+}
+
+/***  wait until all outputs are written  ***/
+int fant_io_flush(FANT_IO *io)
+{
+	int ret;
+
+	pthread_mutex_lock(&io->lock);
+	while (io->no_writes > 0)
+		pthread_cond_wait(&io->done, &io->lock);
+	ret = io->error;
+	pthread_mutex_unlock(&io->lock);
+	return ret;
+}
+
+const char *fant_io_failed(FANT_IO *io)
+{
+	return (io->error_name != NULL) ? io->error_name : "";
+}
+
+/*=====================================================================*/
+
+static void *io_thread(void *arg)
+{
+	FANT_IO     *io = (FANT_IO*)arg;
+	FANT_IO_JOB *job;
+
+	fant_trace_thread("io");
+	pthread_mutex_lock(&io->lock);
+	for (;;)
+	{
+		while ( (io->first == NULL) && !io->stop)
+			pthread_cond_wait(&io->work, &io->lock);
+		if ( (job = io->first) == NULL)
+			break;
+		if ( (io->first = job->next) == NULL)
+			io->last = NULL;
+		pthread_mutex_unlock(&io->lock);
+
+		do_job(job);
+
+		pthread_mutex_lock(&io->lock);
+		if (job->type == FANT_IO_READ)
+			job->done = 1;
+		else if (job->tag >= 0)
+		{
+			/* still in the list of tracked outputs */
+			io->no_writes--;
+			free(job->buf);
+			free(job->fbuf);
+			job->buf = NULL;
+			job->fbuf = NULL;
+			job->done = 1;
+		}
+		else
+		{
+			if ( (job->status != FANT_OK) && (io->error == FANT_OK) )
+			{
+				io->error = job->status;
+				io->error_name = job->name;
+				job->name = NULL;
+			}
+			io->no_writes--;
+			free_job(job);
+		}
+		pthread_cond_broadcast(&io->done);
+	}
+	pthread_mutex_unlock(&io->lock);
+	return NULL;
+}
+
+static void do_job(FANT_IO_JOB *job)
+{
+	FANT_AUDIO audio;
+	FILE  *fp;
+	double t0 = fant_time();
+
+	if (job->type == FANT_IO_READ)
+	{
+		if ( (fp = fopen(job->name, "r")) == NULL)
+			job->status = FANT_ERR_IO;
+		else
+		{
+			if ( (job->status = fant_read_audio(fp, 0, job->big_endian, &audio)) != FANT_OK)
+				;
+			else if ( (audio.rate > 0) && (job->rate > 0) && (audio.rate != job->rate) )
+			{
+				job->status = FANT_ERR_RATE;
+				fant_audio_free(&audio);
+			}
+			else
+			{
+				job->buf = audio.samples;
+				job->no_samples = audio.no_samples;
+			}
+			fclose(fp);
+		}
+	}
+	else
+	{
+		if ( (fp = fopen(job->name, "w")) == NULL)
+			job->status = FANT_ERR_IO;
+		else
+		{
+			if (job->fbuf != NULL)
+				job->status = fant_write_float(fp, job->fbuf, job->no_samples, fant_wav_name(job->name) ? job->rate : 0);
+			else
+				job->status = fant_write_audio(fp, job->buf, job->no_samples, fant_wav_name(job->name) ? job->rate : 0);
+			if (fclose(fp) != 0)
+				job->status = FANT_ERR_IO;
+		}
+	}
+	if (fant_trace_on)
+		fant_trace_span( (job->type == FANT_IO_READ) ? "read" : "write", job->name, t0, fant_time());
+}
+
+static FANT_IO_JOB *new_job(int type, const char *name)
+{
+	FANT_IO_JOB *job;
+
+	if ( (job = (FANT_IO_JOB*)calloc(1, sizeof(FANT_IO_JOB))) == NULL)
+		return NULL;
+	if ( (job->name = strdup(name)) == NULL)
+	{
+		free(job);
+		return NULL;
+	}
+	job->type = type;
+	job->status = FANT_OK;
+	job->tag = -1;
+	return job;
+}
+
+static void free_job(FANT_IO_JOB *job)
+{
+	free(job->name);
+	free(job->buf);
+	free(job->fbuf);
+	free(job);
+}
+
+/* called with io->lock held */
+static void queue_job(FANT_IO *io, FANT_IO_JOB *job)
+{
+	if (io->last == NULL)
+		io->first = job;
+	else
+		io->last->next = job;
+	io->last = job;
+	pthread_cond_signal(&io->work);
+}
+
+/* the writer waits while "depth" outputs are pending */
+static int queue_write(FANT_IO *io, FANT_IO_JOB *job)
+{
+	int ret;
+
+	job->rate = io->rate;
+	pthread_mutex_lock(&io->lock);
+	while ( (io->no_writes >= io->depth) && (io->error == FANT_OK) )
+		pthread_cond_wait(&io->done, &io->lock);
+	if ( (ret = io->error) != FANT_OK)
+		free_job(job);
+	else
+	{
+		io->no_writes++;
+		queue_job(io, job);
+		if (job->tag >= 0)
+		{
+			if (io->last_written == NULL)
+				io->first_written = job;
+			else
+				io->last_written->next_written = job;
+			io->last_written = job;
+		}
+	}
+	pthread_mutex_unlock(&io->lock);
+	return ret;
+}
@@ -0,0 +1,92 @@
+/*
+  ============================================================================
+   File: FANT-IO.H
+  ============================================================================
+
+             ASYNCHRONOUS FILE I/O FOR THE BATCH MODE OF LIBFANT
+
+   A small pool of I/O threads reads the next speech files ahead (in the
+   order they were queued with fant_io_read()) and writes the finished
+   outputs behind (fant_io_write()), so that the processing thread does
+   not wait on storage as long as enough work is queued.
+   At most "depth" outputs are pending; fant_io_write() blocks beyond.
+   Write errors are reported by the next fant_io_write() or by
+   fant_io_flush(), fant_io_failed() returns the name of the file.
+   Outputs queued with fant_io_write_tag() are tracked instead: once
+   written (or failed) they are returned one by one by fant_io_written(),
+   and a failed write does not stop the following ones. Outputs of the
+   same tag are returned once, when all of them are written: as the last
+   one queued, with the first error of them as status.
+   Inputs can be raw or WAV files (see fant-wav.h), raw files are big
+   endian if "big_endian" is set; if "rate" is set, a
+   WAV input of another sample rate fails with FANT_ERR_RATE and outputs
+   named *.wav are written as WAV files of this rate.
+   fant_io_write_float() writes float samples without quantization.
+
+   History:
+   p1a  18-10-26   basic version (thread pool)
+   p1b  18-10-26   tracked outputs
+   p1c  18-10-26   WAV inputs and outputs
+   p1d  18-10-26   float outputs
+   p1e  18-10-26   outputs of a tag tracked together
+   p1f  18-10-26   byte order of raw inputs
+
+  ============================================================================
+*/
+#ifndef FANT_IO_defined
+#define FANT_IO_defined 100
+
+#include <pthread.h>
+#include "fant.h"
+
+#define FANT_IO_READ   1
+#define FANT_IO_WRITE  2
+
+typedef struct FANT_IO_JOB {
+	int                 type;        /* FANT_IO_READ or FANT_IO_WRITE */
+	char               *name;
+	short              *buf;
+	float              *fbuf;        /* float output instead of buf */
+	long                no_samples;
+	int                 status;      /* FANT_OK or error code */
+	int                 done;
+	long                tag;         /* of a tracked output or -1 */
+	int                 rate;        /* of FANT_IO */
+	int                 big_endian;  /* of FANT_IO */
+	struct FANT_IO_JOB *next;        /* queue of the I/O threads */
+	struct FANT_IO_JOB *next_read;   /* reads in the order of fant_io_read() */
+	struct FANT_IO_JOB *next_written; /* tracked outputs in the order queued */
+} FANT_IO_JOB;
+
+typedef struct {
+	pthread_t       *threads;
+	int              no_threads;
+	int              depth;          /* max. number of pending outputs */
+	int              rate;           /* of the samples or 0 (see above) */
+	int              big_endian;     /* raw inputs are big endian */
+	pthread_mutex_t  lock;           /* protects the following members */
+	pthread_cond_t   work;           /* job queued or stop */
+	pthread_cond_t   done;           /* job finished */
+	FANT_IO_JOB     *first, *last;   /* jobs not yet started */
+	FANT_IO_JOB     *first_read, *last_read;
+	FANT_IO_JOB     *first_written, *last_written;  /* tracked outputs, done if written */
+	int              no_writes;      /* pending outputs */
+	int              stop;
+	int              error;          /* first write error */
+	char            *error_name;
+} FANT_IO;
+
+FANT_IO *fant_io_init(int no_threads, int depth);
+int    fant_io_read(FANT_IO *io, const char *name);
+short *fant_io_next(FANT_IO *io, long *no_samples, int *status);
+int    fant_io_write(FANT_IO *io, const char *name, short *buf, long no_samples);
+int    fant_io_write_tag(FANT_IO *io, const char *name, short *buf, long no_samples, long tag);
+int    fant_io_write_float(FANT_IO *io, const char *name, float *buf, long no_samples, long tag);
+FANT_IO_JOB *fant_io_written(FANT_IO *io);
+void   fant_io_release(FANT_IO_JOB *job);
+int    fant_io_flush(FANT_IO *io);
+const char *fant_io_failed(FANT_IO *io);
+void   fant_io_free(FANT_IO *io);
+
+#endif /* FANT_IO_defined */
+/* ......................... End of FANT-IO.H .......................... */
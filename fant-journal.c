@@ -0,0 +1,179 @@
+/*
+********************************************************************************
+*
+*      File             : fant-journal.c
+*      Tested Platforms : Linux-OS
+*      Description      : Journal of the completed utterances of a batch run
+*                         (see fant-journal.h). Each line is flushed when it
+*                         is written, so the journal is complete up to the
+*                         last utterance written before a crash.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#include "fant.h"
+#include "fant-journal.h"
+
+static int  read_journal(FANT_JOURNAL*, FILE*, char*, int);
+static int  grow_tables(FANT_JOURNAL*, long);
+
+/*=====================================================================*/
+
+/***  open a journal, its entries are read if "resume" is set  ***/
+FANT_JOURNAL *fant_journal_open(const char *path, int resume, char *error, int len)
+{
+	FANT_JOURNAL *jrn;
+
+	if ( (jrn = (FANT_JOURNAL*)calloc(1, sizeof(FANT_JOURNAL))) == NULL)
+	{
+		snprintf(error, (size_t)len, "cannot allocate memory");
+		return NULL;
+	}
+	if ( (jrn->fp = fopen(path, resume ? "a+" : "w")) == NULL)
+	{
+		snprintf(error, (size_t)len, "cannot open journal %s", path);
+		free(jrn);
+		return NULL;
+	}
+	if (resume && (read_journal(jrn, jrn->fp, error, len) != FANT_OK) )
+	{
+		fant_journal_close(jrn);
+		return NULL;
+	}
+	return jrn;
+}
+
+/***  samples of a journaled entry, FANT_JOURNAL_NONE or FANT_JOURNAL_MISMATCH  ***/
+long fant_journal_done(FANT_JOURNAL *jrn, long entry, const char *output)
+{
+	if ( (entry < 0) || (entry >= jrn->no_entries) || (jrn->no_samples[entry] < 0) )
+		return FANT_JOURNAL_NONE;
+	if (strcmp(jrn->names[entry], output) != 0)
+		return FANT_JOURNAL_MISMATCH;
+	return jrn->no_samples[entry];
+}
+
+/***  append a completed entry  ***/
+int fant_journal_add(FANT_JOURNAL *jrn, long entry, long no_samples, const char *output)
+{
+	if ( (fprintf(jrn->fp, "%ld\t%ld\t%s\n", entry, no_samples, output) < 0) ||
+	     (fflush(jrn->fp) != 0) )
+		return FANT_ERR_IO;
+	jrn->no_done++;
+	return FANT_OK;
+}
+
+int fant_journal_close(FANT_JOURNAL *jrn)
+{
+	long i;
+	int  ret = FANT_OK;
+
+	if (jrn == NULL)
+		return FANT_OK;
+	if (fclose(jrn->fp) != 0)
+		ret = FANT_ERR_IO;
+	for (i=0 ; i<jrn->no_entries ; i++)
+		free(jrn->names[i]);
+	free(jrn->names);
+	free(jrn->no_samples);
+	free(jrn);
+	return ret;
+}
+
+/*=====================================================================*/
+
+static int read_journal(FANT_JOURNAL *jrn, FILE *fp, char *error, int len)
+{
+	char   *line = NULL, *p, *q;
+	size_t  size = 0;
+	ssize_t n;
+	off_t   valid = 0;
+	long    entry, no_samples, line_no;
+	int     ret = FANT_OK;
+
+	rewind(fp);
+	for (line_no=1 ; (ret == FANT_OK) && ( (n = getline(&line, &size, fp)) > 0) ; line_no++)
+	{
+		/* a line without newline has been cut off (and is removed) */
+		if (line[n-1] != '\n')
+			break;
+		line[n-1] = '\0';
+		entry = strtol(line, &p, 10);
+		if ( (p == line) || (*p++ != '\t') || (entry < 0) )
+			ret = FANT_ERR_PARAM;
+		else
+		{
+			no_samples = strtol(p, &q, 10);
+			if ( (q == p) || (*q++ != '\t') || (no_samples < 0) )
+				ret = FANT_ERR_PARAM;
+		}
+		if (ret != FANT_OK)
+		{
+			snprintf(error, (size_t)len, "line %ld: invalid journal entry", line_no);
+			break;
+		}
+		if (grow_tables(jrn, entry+1) != FANT_OK)
+			ret = FANT_ERR_MEMORY;
+		else
+		{
+			free(jrn->names[entry]);
+			if ( (jrn->names[entry] = strdup(q)) == NULL)
+				ret = FANT_ERR_MEMORY;
+		}
+		if (ret != FANT_OK)
+		{
+			snprintf(error, (size_t)len, "cannot allocate memory");
+			break;
+		}
+		if (jrn->no_samples[entry] < 0)
+			jrn->no_done++;
+		jrn->no_samples[entry] = no_samples;
+		valid += n;
+	}
+	free(line);
+	if (ret != FANT_OK)
+		return ret;
+	fflush(fp);
+	if (ftruncate(fileno(fp), valid) != 0)
+	{
+		snprintf(error, (size_t)len, "cannot truncate journal");
+		return FANT_ERR_IO;
+	}
+	fseeko(fp, 0, SEEK_END);
+	return FANT_OK;
+}
+
+static int grow_tables(FANT_JOURNAL *jrn, long no_entries)
+{
+	long   *no_samples, i, size;
+	char  **names;
+
+	if (no_entries <= jrn->no_entries)
+		return FANT_OK;
+	size = (no_entries > 2*jrn->no_entries) ? no_entries : 2*jrn->no_entries;
+	if ( (no_samples = (long*)realloc(jrn->no_samples, (size_t)size*sizeof(long))) == NULL)
+		return FANT_ERR_MEMORY;
+	jrn->no_samples = no_samples;
+	if ( (names = (char**)realloc(jrn->names, (size_t)size*sizeof(char*))) == NULL)
+		return FANT_ERR_MEMORY;
+	jrn->names = names;
+	for (i=jrn->no_entries ; i<size ; i++)
+	{
+		jrn->no_samples[i] = FANT_JOURNAL_NONE;
+		jrn->names[i] = NULL;
+	}
+	jrn->no_entries = size;
+	return FANT_OK;
+}
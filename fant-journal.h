@@ -0,0 +1,43 @@
+/*
+  ============================================================================
+   File: FANT-JOURNAL.H
+  ============================================================================
+
+             JOURNAL OF COMPLETED UTTERANCES OF A BATCH RUN (--journal)
+
+   One line is appended (and flushed) per utterance whose output has been
+   written completely:
+
+     entry <TAB> no_samples <TAB> output
+
+   entry is the position in the input list or manifest (from 0). A run
+   with --resume skips all journaled entries; their number of samples is
+   kept so that the noise segments and SNRs of the remaining entries are
+   drawn exactly as in an uninterrupted run. A line cut off by a crash is
+   removed when the journal is opened again.
+
+  ============================================================================
+*/
+#ifndef FANT_JOURNAL_defined
+#define FANT_JOURNAL_defined 100
+
+#include <stdio.h>
+
+#define FANT_JOURNAL_NONE      -1   /* entry not journaled */
+#define FANT_JOURNAL_MISMATCH  -2   /* journaled with another output */
+
+typedef struct {
+	FILE   *fp;
+	long   *no_samples;   /* per entry, -1 if not journaled */
+	char  **names;        /* outputs of the journaled entries */
+	long    no_entries;   /* size of the tables */
+	long    no_done;
+} FANT_JOURNAL;
+
+FANT_JOURNAL *fant_journal_open(const char *path, int resume, char *error, int len);
+long fant_journal_done(FANT_JOURNAL *jrn, long entry, const char *output);
+int  fant_journal_add(FANT_JOURNAL *jrn, long entry, long no_samples, const char *output);
+int  fant_journal_close(FANT_JOURNAL *jrn);
+
+#endif /* FANT_JOURNAL_defined */
+/* ....................... End of FANT-JOURNAL.H ....................... */
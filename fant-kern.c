@@ -0,0 +1,626 @@
+/*
+********************************************************************************
+*
+*      File             : fant-kern.c
+*      Tested Platforms : Linux-OS
+*      Description      : Optimized DSP kernels (see fant-kern.h). The FIR
+*                         kernel computes FANT_BLOCK output samples at once:
+*                         each one is accumulated in its own register in the
+*                         order of fir-lib.c (h0[0], h0[1], ...), so the
+*                         compiler can vectorize across the outputs without
+*                         changing a single result. The AVX variants take
+*                         FANT_VBLOCK contiguous outputs in two explicit
+*                         vectors instead. The first lenh0-1 input samples,
+*                         which need the delay line, are copied behind it
+*                         and computed in the same blocks, so that short
+*                         segments (tiles) are fast as well.
+*                         The kernels are written once as inline functions;
+*                         each variant of the registry is a function compiled
+*                         for its instruction set that inlines them. The
+*                         registry chooses the variants with CPUID
+*                         (__builtin_cpu_supports) and checks each chosen one
+*                         against the reference on a probe signal.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*      p1b  18-10-26                   kernel registry, 16 bit conversions
+*      p1c  18-10-26                   FIR filters from the generated tables
+*      p1d  18-10-26                   transition samples in blocks
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "ugst-utl.h"
+#include "fant.h"
+#include "fant-kern.h"
+#include "fant-tables.h"
+
+#define FANT_BLOCK  8    /* output samples per block (decimation) */
+#define FANT_VBLOCK 16   /* output samples per vector block (2 vectors) */
+#define FANT_HIST   1024 /* longest delay line staged for the transition */
+
+/* half a vector block, one AVX register; element-wise float operations,
+   so the results do not depend on the width */
+typedef float VBLOCK __attribute__((vector_size(FANT_VBLOCK/2 * sizeof(float))));
+#define PROBE_LEN   2000 /* samples of the self-test signal */
+
+#define ALWAYS_INLINE  inline __attribute__((always_inline))
+#if defined(__x86_64__) || defined(__i386__)
+#define FANT_KERN_X86
+#define TARGET(isa)    __attribute__((target(isa)))
+#endif
+
+static long fir_down(long, float*, float*, long, float*, float*, long, long*, int);
+static long fir_up(long, float*, float*, long, float*, float*, long, int);
+static void update_delay_line(long, float*, long, float*);
+static long ref_fir(long, float*, SCD_FIR*, float*);
+static void ref_sh2fl(long, short*, float*);
+static long ref_fl2sh(long, float*, short*);
+static int  probe_fir(FANT_FIR_FN);
+static int  probe_conv(FANT_SH2FL_FN, FANT_FL2SH_FN);
+static void select_default(void);
+
+const char *fant_isa_names[FANT_NO_ISAS] = { "reference", "scalar", "avx2", "avx512" };
+
+static const char *slot_names[FANT_NO_KERNELS] = {
+	"fir", "iir", "aweight", "dc", "voltmeter", "sh2fl", "fl2sh" };
+
+/* portable variants until fant_kernels_select() */
+FANT_KERNELS fant_kernels = { fant_fir_kernel, fant_sh2fl_kernel, fant_fl2sh_kernel,
+	{ FANT_ISA_SCALAR, FANT_ISA_REFERENCE, FANT_ISA_REFERENCE, FANT_ISA_REFERENCE,
+	  FANT_ISA_REFERENCE, FANT_ISA_SCALAR, FANT_ISA_SCALAR }, "" };
+
+static int            kernels_selected = 0;
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+
+/*=====================================================================*/
+
+/* wide: vector blocks (AVX and up), else blocks the compiler vectorizes */
+static ALWAYS_INLINE long fir_kernel(long lseg, float *x_ptr, SCD_FIR *fir_ptr, float *y_ptr, int wide)
+{
+	if (fir_ptr->hswitch == 'U')
+		return fir_up(lseg, x_ptr, y_ptr, fir_ptr->lenh0, fir_ptr->h0, fir_ptr->T, fir_ptr->dwn_up, wide);
+	return fir_down(lseg, x_ptr, y_ptr, fir_ptr->lenh0, fir_ptr->h0, fir_ptr->T, fir_ptr->dwn_up,
+		&fir_ptr->k0, wide);
+}
+
+/* sh2fl_alt() of ugst-utl.c with a mask of 0xFFFF */
+static ALWAYS_INLINE void sh2fl_kernel(long n, short *x, float *y)
+{
+	long k;
+
+	for (k=0 ; k<n ; k++)
+		y[k] = (float)(1. / 32768.) * x[k];
+}
+
+/* fl2sh() of ugst-utl.c with rounding and a mask of 0xFFFF; truncating
+   towards zero gives the same as truncating the magnitude. Clipped
+   negative samples give -32767 there, as the compiled reference converts
+   the constant 32768.0 to the short 32767 (an out of range conversion,
+   which the self-test would catch should a compiler do it otherwise) */
+static ALWAYS_INLINE long fl2sh_kernel(long n, float *x, short *iy)
+{
+	long   k, no_ovl = 0;
+	double y;
+
+	for (k=0 ; k<n ; k++)
+	{
+		y = x[k] * 32768;
+		y = (y >= 0.0) ? y + 0.5 : y - 0.5;
+		no_ovl += (y > 32767.0) | (y < -32768.0);
+		y = (y > 32767.0) ? 32767.0 : y;
+		y = (y < -32768.0) ? -32767.0 : y;
+		iy[k] = (short)(int) y;
+	}
+	return no_ovl;
+}
+
+long fant_fir_kernel(long lseg, float *x_ptr, SCD_FIR *fir_ptr, float *y_ptr)
+{
+	return fir_kernel(lseg, x_ptr, fir_ptr, y_ptr, 0);
+}
+
+void fant_sh2fl_kernel(long n, short *x, float *y)
+{
+	sh2fl_kernel(n, x, y);
+}
+
+long fant_fl2sh_kernel(long n, float *x, short *y)
+{
+	return fl2sh_kernel(n, x, y);
+}
+
+#ifdef FANT_KERN_X86
+TARGET("avx2") static long fir_avx2(long lseg, float *x_ptr, SCD_FIR *fir_ptr, float *y_ptr)
+{
+	return fir_kernel(lseg, x_ptr, fir_ptr, y_ptr, 1);
+}
+
+TARGET("avx2") static void sh2fl_avx2(long n, short *x, float *y)
+{
+	sh2fl_kernel(n, x, y);
+}
+
+TARGET("avx2") static long fl2sh_avx2(long n, float *x, short *y)
+{
+	return fl2sh_kernel(n, x, y);
+}
+
+TARGET("avx512f") static long fir_avx512(long lseg, float *x_ptr, SCD_FIR *fir_ptr, float *y_ptr)
+{
+	return fir_kernel(lseg, x_ptr, fir_ptr, y_ptr, 1);
+}
+
+TARGET("avx512f") static void sh2fl_avx512(long n, short *x, float *y)
+{
+	sh2fl_kernel(n, x, y);
+}
+
+TARGET("avx512f") static long fl2sh_avx512(long n, float *x, short *y)
+{
+	return fl2sh_kernel(n, x, y);
+}
+#endif
+
+/*=====================================================================*/
+
+int fant_isa_supported(int isa)
+{
+	switch (isa)
+	{
+	  case FANT_ISA_REFERENCE:
+	  case FANT_ISA_SCALAR:
+		return 1;
+#ifdef FANT_KERN_X86
+	  case FANT_ISA_AVX2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+	  case FANT_ISA_AVX512:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512f");
+#endif
+	  default:
+		return 0;
+	}
+}
+
+FANT_FIR_FN fant_fir_variant(int isa)
+{
+	static const FANT_FIR_FN variants[FANT_NO_ISAS] = { ref_fir, fant_fir_kernel,
+#ifdef FANT_KERN_X86
+		fir_avx2, fir_avx512 };
+#else
+		NULL, NULL };
+#endif
+	return ( (isa < 0) || (isa >= FANT_NO_ISAS) ) ? NULL : variants[isa];
+}
+
+FANT_SH2FL_FN fant_sh2fl_variant(int isa)
+{
+	static const FANT_SH2FL_FN variants[FANT_NO_ISAS] = { ref_sh2fl, fant_sh2fl_kernel,
+#ifdef FANT_KERN_X86
+		sh2fl_avx2, sh2fl_avx512 };
+#else
+		NULL, NULL };
+#endif
+	return ( (isa < 0) || (isa >= FANT_NO_ISAS) ) ? NULL : variants[isa];
+}
+
+FANT_FL2SH_FN fant_fl2sh_variant(int isa)
+{
+	static const FANT_FL2SH_FN variants[FANT_NO_ISAS] = { ref_fl2sh, fant_fl2sh_kernel,
+#ifdef FANT_KERN_X86
+		fl2sh_avx2, fl2sh_avx512 };
+#else
+		NULL, NULL };
+#endif
+	return ( (isa < 0) || (isa >= FANT_NO_ISAS) ) ? NULL : variants[isa];
+}
+
+/***  FIR filter with the coefficients of a generated table  ***/
+SCD_FIR *fant_fir_init(int table)
+{
+	const FANT_FIR_TABLE *tab;
+	SCD_FIR              *fir_ptr;
+
+	if ( (table < 0) || (table >= FANT_NO_FIR_TABLES) )
+		return NULL;
+	tab = &fant_fir_tables[table];
+	/* struct and delay line in one block */
+	if ( (fir_ptr = (SCD_FIR*)calloc(1, sizeof(SCD_FIR) + (size_t)(tab->lenh0 - 1) * sizeof(float))) == NULL)
+		return NULL;
+	fir_ptr->lenh0 = tab->lenh0;
+	fir_ptr->dwn_up = tab->dwn_up;
+	fir_ptr->k0 = 0;
+	fir_ptr->h0 = (float*) tab->h0;   /* never written by the kernels */
+	fir_ptr->T = (float*)(fir_ptr + 1);
+	fir_ptr->hswitch = tab->hswitch;
+	return fir_ptr;
+}
+
+void fant_fir_free(SCD_FIR *fir_ptr)
+{
+	free(fir_ptr);
+}
+
+/***  choose the kernel variants: reference, auto or an instruction set  ***/
+int fant_kernels_select(const char *choice)
+{
+	FANT_KERNELS k;
+	int          max_isa, isa, i;
+	size_t       len;
+
+	if (strcmp(choice, "auto") == 0)
+	{
+		for (max_isa=FANT_NO_ISAS-1 ; !fant_isa_supported(max_isa) ; max_isa--)
+			;
+	}
+	else
+	{
+		for (max_isa=0 ; (max_isa < FANT_NO_ISAS) && (strcmp(choice, fant_isa_names[max_isa]) != 0) ; max_isa++)
+			;
+		if ( (max_isa == FANT_NO_ISAS) || !fant_isa_supported(max_isa) )
+			return FANT_ERR_PARAM;
+	}
+
+	memset(&k, 0, sizeof(k));
+	for (isa=max_isa ; fant_fir_variant(isa) == NULL ; isa--)
+		;
+	k.fir = fant_fir_variant(isa);
+	k.isa[FANT_K_HQ] = isa;
+	for (isa=max_isa ; (fant_sh2fl_variant(isa) == NULL) || (fant_fl2sh_variant(isa) == NULL) ; isa--)
+		;
+	k.sh2fl = fant_sh2fl_variant(isa);
+	k.fl2sh = fant_fl2sh_variant(isa);
+	k.isa[FANT_K_SH2FL] = k.isa[FANT_K_FL2SH] = isa;
+	/* IIR, A-weighting, DC removal and voltmeter: only the reference */
+
+	if ( (k.isa[FANT_K_HQ] != FANT_ISA_REFERENCE) && (probe_fir(k.fir) != 0) )
+	{
+		k.fir = ref_fir;
+		k.isa[FANT_K_HQ] = FANT_ISA_REFERENCE;
+		strcpy(k.report, "(fir failed the self-test) ");
+	}
+	if ( (k.isa[FANT_K_SH2FL] != FANT_ISA_REFERENCE) && (probe_conv(k.sh2fl, k.fl2sh) != 0) )
+	{
+		k.sh2fl = ref_sh2fl;
+		k.fl2sh = ref_fl2sh;
+		k.isa[FANT_K_SH2FL] = k.isa[FANT_K_FL2SH] = FANT_ISA_REFERENCE;
+		strcat(k.report, "(sh2fl/fl2sh failed the self-test) ");
+	}
+	for (i=0 ; i<FANT_NO_KERNELS ; i++)
+	{
+		len = strlen(k.report);
+		snprintf(k.report + len, sizeof(k.report) - len, "%s%s=%s", (i > 0) ? " " : "",
+			slot_names[i], fant_isa_names[k.isa[i]]);
+	}
+	fant_kernels = k;
+	kernels_selected = 1;
+	return FANT_OK;
+}
+
+/***  default choice, FANT_KERNELS or auto, if none was made  ***/
+void fant_kernels_init(void)
+{
+	pthread_once(&kernels_once, select_default);
+}
+
+static void select_default(void)
+{
+	const char *choice = getenv("FANT_KERNELS");
+
+	if (kernels_selected)
+		return;
+	if ( (choice == NULL) || (fant_kernels_select(choice) != FANT_OK) )
+		fant_kernels_select("auto");
+}
+
+/*=====================================================================*/
+
+static long ref_fir(long lseg, float *x_ptr, SCD_FIR *fir_ptr, float *y_ptr)
+{
+	return hq_kernel(lseg, x_ptr, fir_ptr, y_ptr);
+}
+
+static void ref_sh2fl(long n, short *x, float *y)
+{
+	sh2fl_16bit(n, x, y, 1);
+}
+
+static long ref_fl2sh(long n, float *x, short *y)
+{
+	return fl2sh_16bit(n, x, y, 1);
+}
+
+/* a down- and an upsampling filter in segments of various lengths, the
+   variant with the generated coefficients */
+static int probe_fir(FANT_FIR_FN fir)
+{
+	static SCD_FIR *(*const inits[])(void) = { hq_down_3_to_1_init, hq_up_1_to_3_init, p341_16khz_init };
+	static const int tables[] = { FANT_T_DOWN_3_TO_1, FANT_T_UP_1_TO_3, FANT_T_P341_16KHZ };
+	static const long segs[] = { 1, 2, 37, 160, 801, 999 };
+	SCD_FIR *ref, *opt;
+	float   *x, *y_ref, *y_opt;
+	long     i, k, done, len, n;
+	int      f, differ = 0;
+
+	x = (float*)malloc(PROBE_LEN * sizeof(float));
+	y_ref = (float*)malloc(3 * PROBE_LEN * sizeof(float));
+	y_opt = (float*)malloc(3 * PROBE_LEN * sizeof(float));
+	if ( (x == NULL) || (y_ref == NULL) || (y_opt == NULL) )
+		differ = 1;
+	for (i=0 ; !differ && (i<PROBE_LEN) ; i++)
+		x[i] = (float)((i * 7919L) % 2003 - 1001) / 1001.f;
+	for (f=0 ; !differ && (f < (int)(sizeof(inits)/sizeof(inits[0]))) ; f++)
+	{
+		ref = inits[f]();
+		opt = fant_fir_init(tables[f]);
+		if ( (ref == NULL) || (opt == NULL) )
+			differ = 1;
+		for (done=0, i=0 ; !differ && (done<PROBE_LEN) ; done+=len, i++)
+		{
+			len = segs[i % 6];
+			len = (len > PROBE_LEN - done) ? PROBE_LEN - done : len;
+			n = hq_kernel(len, x+done, ref, y_ref);
+			if ( (fir(len, x+done, opt, y_opt) != n) || (memcmp(y_ref, y_opt, (size_t)n*sizeof(float)) != 0) )
+				differ = 1;
+		}
+		for (k=0 ; !differ && (k < ref->lenh0/((ref->hswitch == 'U') ? ref->dwn_up : 1)-1) ; k++)
+			differ = (memcmp(&ref->T[k], &opt->T[k], sizeof(float)) != 0) || (ref->k0 != opt->k0);
+		if (ref != NULL)
+			hq_free(ref);
+		fant_fir_free(opt);
+	}
+	free(x);
+	free(y_ref);
+	free(y_opt);
+	return differ;
+}
+
+/* all 16 bit values, and floats around the rounding and clipping points */
+static int probe_conv(FANT_SH2FL_FN to_float, FANT_FL2SH_FN to_short)
+{
+	short *s, *s_ref;
+	float *y, *y_ref;
+	long   i;
+	int    differ = 1;
+
+	s = (short*)malloc(2 * 65536 * sizeof(short));
+	y = (float*)malloc(2 * 65536 * sizeof(float));
+	if ( (s != NULL) && (y != NULL) )
+	{
+		s_ref = s + 65536;
+		y_ref = y + 65536;
+		for (i=0 ; i<65536 ; i++)
+			s[i] = (short)(i - 32768);
+		ref_sh2fl(65536, s, y_ref);
+		to_float(65536, s, y);
+		differ = (memcmp(y_ref, y, 65536 * sizeof(float)) != 0);
+		for (i=0 ; i<65536 ; i++)
+			y[i] = (i % 2) ? y_ref[i] * 1.0001f + (float)(1. / 65536.) : y_ref[i] * 1.01f;
+		if ( (ref_fl2sh(65536, y, s_ref) != to_short(65536, y, s)) || (memcmp(s_ref, s, 65536 * sizeof(short)) != 0) )
+			differ = 1;
+	}
+	free(s);
+	free(y);
+	return differ;
+}
+
+/*=====================================================================*/
+
+/* outputs of fir_downsampling_kernel() (also for factor 1) for the inputs
+   kx, kx+downfac, ... up to kend, x[kx-lenh0+1] and up must exist;
+   FANT_BLOCK (or FANT_VBLOCK) outputs at once                           */
+static ALWAYS_INLINE long down_outputs(float *x, long kx, long kend, float *y, long lenh0, float *h0,
+	long downfac, int wide)
+{
+	long  ky = 0, kappa, j;
+	float  acc[FANT_BLOCK], sum, hk;
+	VBLOCK xv, xv2, vacc, vacc2;
+
+	/* contiguous inputs without decimation in vector blocks */
+	for ( ; wide && (downfac == 1) && (kx + FANT_VBLOCK-1 <= kend) ; kx += FANT_VBLOCK)
+	{
+		memcpy(&xv, &x[kx], sizeof(xv));
+		memcpy(&xv2, &x[kx + FANT_VBLOCK/2], sizeof(xv2));
+		vacc = xv * h0[0];
+		vacc2 = xv2 * h0[0];
+		for (kappa = 1 ; kappa <= lenh0 - 1 ; kappa++)
+		{
+			memcpy(&xv, &x[kx - kappa], sizeof(xv));
+			memcpy(&xv2, &x[kx + FANT_VBLOCK/2 - kappa], sizeof(xv2));
+			vacc += xv * h0[kappa];
+			vacc2 += xv2 * h0[kappa];
+		}
+		memcpy(&y[ky], &vacc, sizeof(vacc));
+		memcpy(&y[ky + FANT_VBLOCK/2], &vacc2, sizeof(vacc2));
+		ky += FANT_VBLOCK;
+	}
+	for ( ; kx + (FANT_BLOCK-1)*downfac <= kend ; kx += FANT_BLOCK*downfac)
+	{
+		for (j=0 ; j<FANT_BLOCK ; j++)
+			acc[j] = x[kx + j*downfac] * h0[0];
+		for (kappa = 1 ; kappa <= lenh0 - 1 ; kappa++)
+		{
+			hk = h0[kappa];
+			for (j=0 ; j<FANT_BLOCK ; j++)
+				acc[j] += x[kx + j*downfac - kappa] * hk;
+		}
+		for (j=0 ; j<FANT_BLOCK ; j++)
+			y[ky++] = acc[j];
+	}
+	for ( ; kx <= kend ; kx += downfac)
+	{
+		sum = x[kx] * h0[0];
+		for (kappa = 1 ; kappa <= lenh0 - 1 ; kappa++)
+			sum += x[kx - kappa] * h0[kappa];
+		y[ky++] = sum;
+	}
+	return ky;
+}
+
+/* fir_downsampling_kernel() of fir-lib.c (also for factor 1) */
+static ALWAYS_INLINE long fir_down(long lenx, float *x, float *y, long lenh0, float *h0, float *T,
+	long downfac, long *k0, int wide)
+{
+	long  ktrans, kx, kStart, ky = 0, kappa, no;
+	float  z[2*FANT_HIST], sum;
+
+	/* transition with samples of the delay line: staged behind the
+	   delay line, so that they are computed in blocks as well       */
+	kStart = *k0;
+	ktrans = (lenh0 - 1 > lenx - 1) ? lenx - 1 : lenh0 - 1;
+	if ( (lenh0 <= FANT_HIST) && (*k0 <= ktrans) )
+	{
+		memcpy(z, T, (size_t)(lenh0 - 1) * sizeof(float));
+		memcpy(&z[lenh0 - 1], x, (size_t)(ktrans + 1) * sizeof(float));
+		ky = down_outputs(&z[lenh0 - 1], *k0, ktrans, y, lenh0, h0, downfac, wide);
+		kStart = *k0 + (ky - 1)*downfac;
+	}
+	for (kx = *k0 ; (lenh0 > FANT_HIST) && (kx <= ktrans) ; kx += downfac)
+	{
+		sum = x[kx] * h0[0];
+		for (kappa = 1 ; kappa <= kx ; kappa++)
+			sum += x[kx - kappa] * h0[kappa];
+		for (kappa = kx + 1 ; kappa < lenh0 ; kappa++)
+			sum += T[lenh0 - 2 + kx + 1 - kappa] * h0[kappa];
+		y[ky++] = sum;
+		kStart = kx;
+	}
+
+	/* remaining samples from x */
+	*k0 = kStart;
+	kx = kStart + downfac;
+	if ( (no = down_outputs(x, kx, lenx - 1, &y[ky], lenh0, h0, downfac, wide)) > 0)
+		*k0 = kx + (no - 1)*downfac;
+	ky += no;
+	*k0 = *k0 + downfac - lenx;
+
+	update_delay_line(lenx, x, lenh0 - 1, T);
+	return ky;
+}
+
+/* outputs of fir_upsampling_kernel() for the inputs kx ... kend, x[kx-lenp+1]
+   and up must exist; FANT_VBLOCK or FANT_BLOCK inputs per phase at once    */
+static ALWAYS_INLINE long up_outputs(float *x, long kx, long kend, float *y, long lenp, float *h0,
+	long iupfac, int wide)
+{
+	long  iup, ky = 0, kappa, j;
+	float  acc[FANT_VBLOCK], sum, hk;
+	VBLOCK xv, xv2, vacc, vacc2;
+
+	for ( ; wide && (kx + FANT_VBLOCK - 1 <= kend) ; kx += FANT_VBLOCK)
+	{
+		for (iup = 0 ; iup <= iupfac - 1 ; iup++)
+		{
+			memcpy(&xv, &x[kx], sizeof(xv));
+			memcpy(&xv2, &x[kx + FANT_VBLOCK/2], sizeof(xv2));
+			vacc = xv * h0[iup];
+			vacc2 = xv2 * h0[iup];
+			for (kappa = 1 ; kappa <= lenp - 1 ; kappa++)
+			{
+				memcpy(&xv, &x[kx - kappa], sizeof(xv));
+				memcpy(&xv2, &x[kx + FANT_VBLOCK/2 - kappa], sizeof(xv2));
+				vacc += xv * h0[iup + kappa * iupfac];
+				vacc2 += xv2 * h0[iup + kappa * iupfac];
+			}
+			memcpy(acc, &vacc, sizeof(vacc));
+			memcpy(acc + FANT_VBLOCK/2, &vacc2, sizeof(vacc2));
+			for (j=0 ; j<FANT_VBLOCK ; j++)
+				y[ky + j*iupfac + iup] = acc[j];
+		}
+		ky += FANT_VBLOCK*iupfac;
+	}
+	for ( ; kx + FANT_BLOCK - 1 <= kend ; kx += FANT_BLOCK)
+	{
+		for (iup = 0 ; iup <= iupfac - 1 ; iup++)
+		{
+			for (j=0 ; j<FANT_BLOCK ; j++)
+				acc[j] = x[kx + j] * h0[iup];
+			for (kappa = 1 ; kappa <= lenp - 1 ; kappa++)
+			{
+				hk = h0[iup + kappa * iupfac];
+				for (j=0 ; j<FANT_BLOCK ; j++)
+					acc[j] += x[kx + j - kappa] * hk;
+			}
+			for (j=0 ; j<FANT_BLOCK ; j++)
+				y[ky + j*iupfac + iup] = acc[j];
+		}
+		ky += FANT_BLOCK*iupfac;
+	}
+	for ( ; kx <= kend ; kx++)
+	{
+		for (iup = 0 ; iup <= iupfac - 1 ; iup++)
+		{
+			sum = x[kx] * h0[iup];
+			for (kappa = 1 ; kappa <= lenp - 1 ; kappa++)
+				sum += x[kx - kappa] * h0[iup + kappa * iupfac];
+			y[ky++] = sum;
+		}
+	}
+	return ky;
+}
+
+/* fir_upsampling_kernel() of fir-lib.c */
+static ALWAYS_INLINE long fir_up(long lenx, float *x, float *y, long lenh0, float *h0, float *T, long iupfac,
+	int wide)
+{
+	long  ktrans, iup, kx, kStart = 0, ky = 0, kappa, lenp = lenh0 / iupfac;
+	float  z[2*FANT_HIST], sum;
+
+	/* transition with samples of the delay line, staged as in fir_down() */
+	ktrans = (lenp > lenx) ? lenx : lenp;
+	if ( (lenp <= FANT_HIST) && (ktrans > 0) )
+	{
+		memcpy(z, T, (size_t)(lenp - 1) * sizeof(float));
+		memcpy(&z[lenp - 1], x, (size_t)ktrans * sizeof(float));
+		ky = up_outputs(&z[lenp - 1], 0, ktrans - 1, y, lenp, h0, iupfac, wide);
+		kStart = ktrans - 1;
+	}
+	for (kx = 0 ; (lenp > FANT_HIST) && (kx <= ktrans - 1) ; kx++)
+	{
+		for (iup = 0 ; iup <= iupfac - 1 ; iup++)
+		{
+			sum = x[kx] * h0[iup];
+			for (kappa = 1 ; kappa <= kx ; kappa++)
+				sum += x[kx - kappa] * h0[iup + kappa * iupfac];
+			for (kappa = kx + 1 ; kappa < lenp ; kappa++)
+				sum += T[lenp - 2 + kx + 1 - kappa] * h0[iup + kappa * iupfac];
+			y[ky++] = sum;
+		}
+		kStart = kx;
+	}
+
+	/* remaining samples from x */
+	ky += up_outputs(x, kStart + 1, lenx - 1, &y[ky], lenp, h0, iupfac, wide);
+
+	update_delay_line(lenx, x, lenp - 1, T);
+	return ky;
+}
+
+/* keep the last "lent" input samples in T */
+static ALWAYS_INLINE void update_delay_line(long lenx, float *x, long lent, float *T)
+{
+	long kappa;
+
+	if (lenx >= lent)
+	{
+		for (kappa = 0 ; kappa <= lent - 1 ; kappa++)
+			T[kappa] = x[lenx - lent + kappa];
+	}
+	else
+	{
+		for (kappa = 0 ; kappa <= lent - 1 - lenx ; kappa++)
+			T[kappa] = T[kappa + lenx];
+		for (kappa = lent - lenx ; kappa <= lent - 1 ; kappa++)
+			T[kappa] = x[lenx - lent + kappa];
+	}
+}
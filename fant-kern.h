@@ -0,0 +1,88 @@
+/*
+  ============================================================================
+   File: FANT-KERN.H
+  ============================================================================
+
+                     OPTIMIZED DSP KERNELS OF LIBFANT
+
+   Drop-in replacements of the kernels of the ITU-T STL sources (which stay
+   unchanged as the reference). They work on the same state structures,
+   keep the same state for segment-wise calls and compute every output
+   sample with the same float operations in the same order, so their
+   results are bit-exact; fant_check (make -f fant_check.make check)
+   compares them with the reference on random signals and segmentations.
+   Bit-exactness needs a compiler that does not contract a*b+c
+   (-ffp-contract=off, as in the make files).
+
+   FANT_..._ULP is the tolerance of a kernel in units in the last place
+   of a float output sample (0: bit-exact).
+
+   The kernel registry (fant_kernels) holds the variant of every kernel
+   used by the library, chosen once by fant_kernels_select():
+
+     reference  the ITU-T STL functions
+     auto       the best variant the CPU supports (CPUID)
+     <isa>      the best variant up to scalar, avx2 or avx512
+
+   The portable C variants (scalar) are the compiler's baseline for the
+   target (SSE2 on x86-64); the avx2 and avx512 variants are the same
+   code compiled for these instruction sets. A kernel without a variant
+   for an instruction set uses the next lower one. Every chosen variant
+   is compared with the reference on a probe signal; one that differs is
+   replaced by the reference. fant_init() chooses the variants from the
+   environment variable FANT_KERNELS (else auto) unless fant_kernels_select()
+   was called before.
+
+   History:
+   p1a  18-10-26   basic version (FIR)
+   p1b  18-10-26   kernel registry with CPU dispatch, 16 bit conversions
+
+  ============================================================================
+*/
+#ifndef FANT_KERN_defined
+#define FANT_KERN_defined 100
+
+#include "firflt.h"
+#include "fant-perf.h"
+
+#define FANT_FIR_ULP  0
+#define FANT_CONV_ULP 0
+
+#define FANT_ISA_REFERENCE  0
+#define FANT_ISA_SCALAR     1
+#define FANT_ISA_AVX2       2
+#define FANT_ISA_AVX512     3
+#define FANT_NO_ISAS        4
+
+typedef long (*FANT_FIR_FN)(long lseg, float *x_ptr, SCD_FIR *fir_ptr, float *y_ptr);
+typedef void (*FANT_SH2FL_FN)(long n, short *x, float *y);
+typedef long (*FANT_FL2SH_FN)(long n, float *x, short *y);
+
+typedef struct {
+	FANT_FIR_FN    fir;
+	FANT_SH2FL_FN  sh2fl;
+	FANT_FL2SH_FN  fl2sh;
+	int            isa[FANT_NO_KERNELS];  /* variant of each kernel (FANT_K_...) */
+	char           report[256];           /* for the log file */
+} FANT_KERNELS;
+
+extern FANT_KERNELS fant_kernels;
+extern const char  *fant_isa_names[FANT_NO_ISAS];
+
+/* hq_kernel(): outputs computed in blocks held in registers */
+long fant_fir_kernel(long lseg, float *x_ptr, SCD_FIR *fir_ptr, float *y_ptr);
+/* sh2fl_16bit(n, x, y, 1) and fl2sh_16bit(n, x, y, 1) */
+void fant_sh2fl_kernel(long n, short *x, float *y);
+long fant_fl2sh_kernel(long n, float *x, short *y);
+
+int  fant_isa_supported(int isa);
+/* variant of a kernel for an instruction set or NULL */
+FANT_FIR_FN   fant_fir_variant(int isa);
+FANT_SH2FL_FN fant_sh2fl_variant(int isa);
+FANT_FL2SH_FN fant_fl2sh_variant(int isa);
+
+int  fant_kernels_select(const char *choice);
+void fant_kernels_init(void);
+
+#endif /* FANT_KERN_defined */
+/* ........................ End of FANT-KERN.H ......................... */
@@ -0,0 +1,384 @@
+/*
+********************************************************************************
+*
+*      File             : fant-manifest.c
+*      Tested Platforms : Linux-OS
+*      Description      : Parser of job manifests (TSV or JSON lines, see
+*                         fant-manifest.h). The manifest is mapped with mmap()
+*                         and parsed in one pass; all strings are allocated,
+*                         so there is no limit for the length of paths.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "fant.h"
+#include "fant-manifest.h"
+
+#define NO_COLUMNS  6
+
+enum { COL_INPUT, COL_OUTPUT, COL_NOISE, COL_START, COL_SNR, COL_FILTER };
+static const char *column_names[NO_COLUMNS] = { "input", "output", "noise", "start", "snr", "filter" };
+
+typedef struct {
+	const char *p, *end;     /* rest of the current line */
+	long        line;
+	char       *error;
+	int         len;
+} PARSER;
+
+static int  parse_tsv_line(PARSER*, FANT_JOB*);
+static int  parse_json_line(PARSER*, FANT_JOB*);
+static int  parse_json_string(PARSER*, char**);
+static int  set_column(PARSER*, FANT_JOB*, int, const char*, size_t);
+static int  parse_error(PARSER*, const char*, const char*);
+static void skip_space(PARSER*);
+static void free_job(FANT_JOB*);
+
+/*=====================================================================*/
+
+/***  returns NULL and a message in "error" if the manifest is not valid  ***/
+FANT_MANIFEST *fant_read_manifest(const char *path, char *error, int len)
+{
+	FANT_MANIFEST *man;
+	FANT_JOB       job, *jobs;
+	PARSER         ps;
+	struct stat    st;
+	const char    *data = NULL, *p, *end, *eol;
+	long           max_jobs = 0;
+	int            fd, json = 0, ret = FANT_OK;
+
+	if ( (fd = open(path, O_RDONLY)) < 0)
+	{
+		snprintf(error, (size_t)len, "cannot open manifest %s", path);
+		return NULL;
+	}
+	if ( (fstat(fd, &st) < 0) || ( (man = (FANT_MANIFEST*)calloc(1, sizeof(FANT_MANIFEST))) == NULL) )
+	{
+		close(fd);
+		snprintf(error, (size_t)len, "cannot read manifest %s", path);
+		return NULL;
+	}
+	if ( (st.st_size > 0) &&
+	     ( (data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) )
+	{
+		close(fd);
+		free(man);
+		snprintf(error, (size_t)len, "cannot map manifest %s", path);
+		return NULL;
+	}
+	close(fd);
+
+	p = data;
+	end = data + st.st_size;
+	while ( (p < end) && isspace((unsigned char)*p) )
+		p++;
+	json = (p < end) && (*p == '{');
+
+	ps.error = error;
+	ps.len = len;
+	for (p=data, ps.line=1 ; (p < end) && (ret == FANT_OK) ; p=eol+1, ps.line++)
+	{
+		if ( (eol = memchr(p, '\n', (size_t)(end-p))) == NULL)
+			eol = end;
+		ps.p = p;
+		ps.end = eol;
+		if ( (ps.end > ps.p) && (ps.end[-1] == '\r') )
+			ps.end--;
+		skip_space(&ps);
+		if ( (ps.p == ps.end) || (*ps.p == '#') )
+			continue;
+
+		memset(&job, 0, sizeof(job));
+		job.start = FANT_RANDOM;
+		job.snr = NONE;
+		job.filter_type = NONE;
+		job.line = ps.line;
+		ps.p = p;
+		ret = json ? parse_json_line(&ps, &job) : parse_tsv_line(&ps, &job);
+		if ( (ret == FANT_OK) && ( (job.input == NULL) || (job.output == NULL) ) )
+			ret = parse_error(&ps, "input and output required", "");
+		if ( (ret == FANT_OK) && (man->no_jobs == max_jobs) )
+		{
+			if ( (jobs = (FANT_JOB*)realloc(man->jobs, (size_t)(max_jobs+4096)*sizeof(FANT_JOB))) == NULL)
+				ret = parse_error(&ps, "cannot allocate memory", "");
+			else
+			{
+				man->jobs = jobs;
+				max_jobs += 4096;
+			}
+		}
+		if (ret == FANT_OK)
+			man->jobs[man->no_jobs++] = job;
+		else
+			free_job(&job);
+	}
+	if (data != NULL)
+		munmap((void*)data, (size_t)st.st_size);
+	if (ret != FANT_OK)
+	{
+		fant_free_manifest(man);
+		return NULL;
+	}
+	return man;
+}
+
+void fant_free_manifest(FANT_MANIFEST *man)
+{
+	long i;
+
+	if (man == NULL)
+		return;
+	for (i=0 ; i<man->no_jobs ; i++)
+		free_job(&man->jobs[i]);
+	free(man->jobs);
+	free(man);
+}
+
+/*=====================================================================*/
+
+/***  input <TAB> output [<TAB> noise [<TAB> start [<TAB> snr [<TAB> filter]]]]  ***/
+static int parse_tsv_line(PARSER *ps, FANT_JOB *job)
+{
+	const char *tab;
+	int         col;
+
+	for (col=0 ; ps->p <= ps->end ; col++)
+	{
+		if ( (tab = memchr(ps->p, '\t', (size_t)(ps->end-ps->p))) == NULL)
+			tab = ps->end;
+		if (col == NO_COLUMNS)
+			return parse_error(ps, "too many columns", "");
+		if (set_column(ps, job, col, ps->p, (size_t)(tab-ps->p)) != FANT_OK)
+			return FANT_ERR_PARAM;
+		ps->p = tab+1;
+	}
+	return FANT_OK;
+}
+
+/***  {"key": value, ...}  ***/
+static int parse_json_line(PARSER *ps, FANT_JOB *job)
+{
+	char       *key, *value, *num_end, number[64];
+	int         col;
+	size_t      n;
+
+	skip_space(ps);
+	if ( (ps->p == ps->end) || (*ps->p++ != '{') )
+		return parse_error(ps, "object expected", "");
+	skip_space(ps);
+	if ( (ps->p < ps->end) && (*ps->p == '}') )
+		ps->p++;
+	else for (;;)
+	{
+		if (parse_json_string(ps, &key) != FANT_OK)
+			return FANT_ERR_PARAM;
+		skip_space(ps);
+		if ( (ps->p == ps->end) || (*ps->p++ != ':') )
+		{
+			free(key);
+			return parse_error(ps, "':' expected", "");
+		}
+		skip_space(ps);
+		for (col=0 ; (col < NO_COLUMNS) && (strcmp(key, column_names[col]) != 0) ; col++)
+			;
+		free(key);
+
+		if ( (ps->p < ps->end) && (*ps->p == '"') )
+		{
+			if (parse_json_string(ps, &value) != FANT_OK)
+				return FANT_ERR_PARAM;
+			if ( (col < NO_COLUMNS) && (set_column(ps, job, col, value, strlen(value)) != FANT_OK) )
+			{
+				free(value);
+				return FANT_ERR_PARAM;
+			}
+			free(value);
+		}
+		else
+		{
+			/* number, null, true or false */
+			for (n=0 ; (ps->p+n < ps->end) && (strchr(",} \t", ps->p[n]) == NULL) ; n++)
+				;
+			if ( (n == 0) || (n >= sizeof(number)) )
+				return parse_error(ps, "invalid value", "");
+			memcpy(number, ps->p, n);
+			number[n] = '\0';
+			ps->p += n;
+			if (strcmp(number, "null") == 0)
+				;
+			else if ( (strcmp(number, "true") == 0) || (strcmp(number, "false") == 0) )
+			{
+				if (col < NO_COLUMNS)
+					return parse_error(ps, "invalid value for ", column_names[col]);
+			}
+			else
+			{
+				strtod(number, &num_end);
+				if (*num_end != '\0')
+					return parse_error(ps, "invalid value ", number);
+				if ( (col == COL_START) || (col == COL_SNR) )
+				{
+					if (set_column(ps, job, col, number, n) != FANT_OK)
+						return FANT_ERR_PARAM;
+				}
+				else if (col < NO_COLUMNS)
+					return parse_error(ps, "string expected for ", column_names[col]);
+			}
+		}
+
+		skip_space(ps);
+		if (ps->p == ps->end)
+			return parse_error(ps, "'}' expected", "");
+		if (*ps->p == '}')
+		{
+			ps->p++;
+			break;
+		}
+		if (*ps->p++ != ',')
+			return parse_error(ps, "',' expected", "");
+		skip_space(ps);
+	}
+	skip_space(ps);
+	if (ps->p != ps->end)
+		return parse_error(ps, "one object per line expected", "");
+	return FANT_OK;
+}
+
+static int parse_json_string(PARSER *ps, char **str)
+{
+	char        *s;
+	const char  *p;
+	unsigned int code;
+	size_t       n = 0;
+
+	if ( (ps->p == ps->end) || (*ps->p != '"') )
+		return parse_error(ps, "string expected", "");
+	/* the decoded string is never longer than the line */
+	if ( (s = (char*)malloc((size_t)(ps->end-ps->p))) == NULL)
+		return parse_error(ps, "cannot allocate memory", "");
+	for (p=ps->p+1 ; (p < ps->end) && (*p != '"') ; p++)
+	{
+		if (*p != '\\')
+		{
+			s[n++] = *p;
+			continue;
+		}
+		if (++p == ps->end)
+			break;
+		switch (*p)
+		{
+		  case 'b':  s[n++] = '\b'; break;
+		  case 'f':  s[n++] = '\f'; break;
+		  case 'n':  s[n++] = '\n'; break;
+		  case 'r':  s[n++] = '\r'; break;
+		  case 't':  s[n++] = '\t'; break;
+		  case 'u':
+			/* only characters up to 0xff */
+			if ( (ps->end-p < 5) || (sscanf(p+1, "%4x", &code) != 1) || (code > 0xff) || (code == 0) )
+			{
+				free(s);
+				return parse_error(ps, "unsupported escape sequence in string", "");
+			}
+			s[n++] = (char) code;
+			p += 4;
+			break;
+		  default:   s[n++] = *p; break;
+		}
+	}
+	if (p == ps->end)
+	{
+		free(s);
+		return parse_error(ps, "unterminated string", "");
+	}
+	s[n] = '\0';
+	ps->p = p+1;
+	*str = s;
+	return FANT_OK;
+}
+
+static int set_column(PARSER *ps, FANT_JOB *job, int col, const char *value, size_t n)
+{
+	char  *s, *num_end;
+
+	if ( (n == 0) || ( (n == 1) && (*value == '-') ) )
+		return FANT_OK;
+	if ( (s = (char*)malloc(n+1)) == NULL)
+		return parse_error(ps, "cannot allocate memory", "");
+	memcpy(s, value, n);
+	s[n] = '\0';
+
+	switch (col)
+	{
+	  case COL_INPUT:
+		free(job->input);
+		job->input = s;
+		return FANT_OK;
+	  case COL_OUTPUT:
+		free(job->output);
+		job->output = s;
+		return FANT_OK;
+	  case COL_NOISE:
+		free(job->noise);
+		job->noise = s;
+		return FANT_OK;
+	  case COL_START:
+		job->start = strtol(s, &num_end, 10);
+		if ( (*num_end != '\0') || (job->start < 0) )
+			break;
+		free(s);
+		return FANT_OK;
+	  case COL_SNR:
+		job->snr = strtod(s, &num_end);
+		if (*num_end != '\0')
+			break;
+		free(s);
+		return FANT_OK;
+	  case COL_FILTER:
+		if ( strcmp(s, "g712") == 0 )       job->filter_type = G712;
+		else if (strcmp(s, "p341") == 0)  job->filter_type = P341;
+		else if (strcmp(s, "irs") == 0)   job->filter_type = IRS;
+		else if (strcmp(s, "mirs") == 0)  job->filter_type = MIRS;
+		else
+			break;
+		free(s);
+		return FANT_OK;
+	}
+	parse_error(ps, "invalid value ", s);
+	free(s);
+	return FANT_ERR_PARAM;
+}
+
+static int parse_error(PARSER *ps, const char *msg, const char *arg)
+{
+	snprintf(ps->error, (size_t)ps->len, "line %ld: %s%s", ps->line, msg, arg);
+	return FANT_ERR_PARAM;
+}
+
+static void skip_space(PARSER *ps)
+{
+	while ( (ps->p < ps->end) && isspace((unsigned char)*ps->p) )
+		ps->p++;
+}
+
+static void free_job(FANT_JOB *job)
+{
+	free(job->input);
+	free(job->output);
+	free(job->noise);
+}
@@ -0,0 +1,53 @@
+/*
+  ============================================================================
+   File: FANT-MANIFEST.H
+  ============================================================================
+
+                   JOB MANIFEST OF FILTER_ADD_NOISE (--manifest)
+
+   One row per utterance, either tab separated (TSV) with the columns
+
+     input  output  [noise  [start  [snr  [filter]]]]
+
+   ("-" or an empty column for the value given on the command line,
+   lines starting with '#' are ignored) or JSON lines (JSONL) like
+
+     {"input": "a.raw", "output": "b.raw", "noise": "babble.raw",
+      "start": 1200, "snr": 5.0, "filter": "p341"}
+
+   The format is recognized from the first character of the file ('{').
+   noise  : noise file, "none" for no noise adding
+   start  : 1st noise sample (else drawn as in the list mode)
+   snr    : SNR in dB (else -s/-w)
+   filter : g712, p341, irs or mirs (else -f)
+   Other keys of a JSON object are ignored, their values have to be
+   strings, numbers, true, false or null.
+
+  ============================================================================
+*/
+#ifndef FANT_MANIFEST_defined
+#define FANT_MANIFEST_defined 100
+
+#define FANT_JOB_NO_NOISE  "none"
+
+typedef struct {
+	char   *input;
+	char   *output;
+	char   *noise;        /* noise file, FANT_JOB_NO_NOISE or NULL for -n */
+	long    start;        /* FANT_RANDOM if not given */
+	double  snr;          /* NONE if not given */
+	int     filter_type;  /* NONE if not given */
+	int     noise_id;     /* resolved by the caller */
+	long    line;         /* line in the manifest (for messages) */
+} FANT_JOB;
+
+typedef struct {
+	FANT_JOB *jobs;
+	long      no_jobs;
+} FANT_MANIFEST;
+
+FANT_MANIFEST *fant_read_manifest(const char *path, char *error, int len);
+void fant_free_manifest(FANT_MANIFEST *man);
+
+#endif /* FANT_MANIFEST_defined */
+/* ...................... End of FANT-MANIFEST.H ....................... */
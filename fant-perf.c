@@ -0,0 +1,225 @@
+/*
+********************************************************************************
+*
+*      File             : fant-perf.c
+*      Tested Platforms : Linux-OS
+*      Description      : Per-thread perf_event counter groups and totals per
+*                         DSP kernel (see fant-perf.h). Counters that cannot
+*                         be opened are left out, the wall time per kernel
+*                         is always measured.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*      p1b  18-10-26                   kernel variant in the report
+*      p1c  18-10-26                   thread records of a former run not reused
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "fant.h"
+#include "fant-perf.h"
+#include "fant-kern.h"
+
+int fant_perf_on = 0;
+
+static const char *kernel_names[FANT_NO_KERNELS] = {
+	"hq_kernel", "cascade_iir_kernel", "AWeightFil", "DCOffsetFil", "speech_voltmeter",
+	"sh2fl_16bit", "fl2sh_16bit" };
+
+static const uint64_t counter_configs[FANT_NO_COUNTERS] = {
+	PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES };
+
+static FANT_PERF_THREAD *threads;
+static int               open_error;      /* errno of the 1st failed counter */
+static pthread_mutex_t   threads_lock = PTHREAD_MUTEX_INITIALIZER;
+static int               generation;      /* of the thread records, per write */
+static __thread FANT_PERF_THREAD *thread;
+static __thread int               thread_generation;
+
+static FANT_PERF_THREAD *this_thread(void);
+static void read_counts(FANT_PERF_THREAD*, uint64_t*);
+static void write_ratio(FILE*, const char*, double, double, int);
+
+/*=====================================================================*/
+
+void fant_perf_start(void)
+{
+	fant_perf_on = 1;
+}
+
+void fant_perf_begin(FANT_PERF_SNAP *snap)
+{
+	FANT_PERF_THREAD *t;
+
+	if ( (t = this_thread()) != NULL)
+		read_counts(t, snap->counts);
+	snap->time = fant_time();
+}
+
+/***  add a kernel call to the totals of the calling thread  ***/
+void fant_perf_end(FANT_PERF_SNAP *snap, int kernel, long no_samples)
+{
+	FANT_PERF_THREAD *t;
+	FANT_PERF_KERNEL *k;
+	uint64_t          counts[FANT_NO_COUNTERS];
+	double            now = fant_time();
+	int               i;
+
+	if ( (t = this_thread()) == NULL)
+		return;
+	read_counts(t, counts);
+	k = &t->kernels[kernel];
+	k->calls++;
+	k->samples += (double)no_samples;
+	k->time += now - snap->time;
+	for (i=0 ; i<FANT_NO_COUNTERS ; i++)
+		k->counts[i] += counts[i] - snap->counts[i];
+}
+
+/***  totals of all threads as JSON, the counters are closed  ***/
+int fant_perf_write(const char *path)
+{
+	FANT_PERF_THREAD *t;
+	FANT_PERF_KERNEL  sum[FANT_NO_KERNELS];
+	FILE             *fp;
+	int               available[FANT_NO_COUNTERS], i, j, ret = FANT_OK;
+
+	fant_perf_on = 0;
+	memset(sum, 0, sizeof(sum));
+	for (i=0 ; i<FANT_NO_COUNTERS ; i++)
+		available[i] = (threads != NULL);
+	for (t=threads ; t!=NULL ; t=t->next)
+	{
+		for (i=0 ; i<FANT_NO_COUNTERS ; i++)
+			available[i] = available[i] && (t->fd[i] >= 0);
+		for (j=0 ; j<FANT_NO_KERNELS ; j++)
+		{
+			sum[j].calls += t->kernels[j].calls;
+			sum[j].samples += t->kernels[j].samples;
+			sum[j].time += t->kernels[j].time;
+			for (i=0 ; i<FANT_NO_COUNTERS ; i++)
+				sum[j].counts[i] += t->kernels[j].counts[i];
+		}
+	}
+
+	if ( (fp = fopen(path, "w")) == NULL)
+		ret = FANT_ERR_IO;
+	else
+	{
+		fprintf(fp, "{\"counters\": %s", available[0] ? "true" : "false");
+		if (!available[0])
+			fprintf(fp, ", \"reason\": \"%s%s\"", (open_error != 0) ? "perf_event_open: " : "",
+				(open_error != 0) ? strerror(open_error) : "no kernel calls");
+		fprintf(fp, ",\n \"kernels\": {");
+		for (j=0 ; j<FANT_NO_KERNELS ; j++)
+		{
+			fprintf(fp, "%s\n  \"%s\": {\"variant\": \"%s\", \"calls\": %ld, \"samples\": %.0f", (j > 0) ? "," : "",
+				kernel_names[j], fant_isa_names[fant_kernels.isa[j]], sum[j].calls, sum[j].samples);
+			write_ratio(fp, "ns_per_sample", 1e9 * sum[j].time, sum[j].samples, 1);
+			write_ratio(fp, "cycles_per_sample", (double)sum[j].counts[0], sum[j].samples, available[0]);
+			write_ratio(fp, "ipc", (double)sum[j].counts[1], (double)sum[j].counts[0], available[0] && available[1]);
+			write_ratio(fp, "cache_miss_rate", (double)sum[j].counts[3], (double)sum[j].counts[2], available[2] && available[3]);
+			fprintf(fp, "}");
+		}
+		fprintf(fp, "}}\n");
+		if (fclose(fp) != 0)
+			ret = FANT_ERR_IO;
+	}
+
+	pthread_mutex_lock(&threads_lock);
+	while ( (t = threads) != NULL)
+	{
+		threads = t->next;
+		for (i=0 ; i<FANT_NO_COUNTERS ; i++)
+		{
+			if (t->fd[i] >= 0)
+				close(t->fd[i]);
+		}
+		free(t);
+	}
+	/* the records of the threads are gone, a new run opens new ones */
+	generation++;
+	pthread_mutex_unlock(&threads_lock);
+	return ret;
+}
+
+/*=====================================================================*/
+
+/* counters of the calling thread, opened at its first measurement */
+static FANT_PERF_THREAD *this_thread(void)
+{
+	struct perf_event_attr attr;
+	FANT_PERF_THREAD      *t;
+	int                    i, error = 0;
+
+	if ( (thread != NULL) && (thread_generation == generation) )
+		return thread;
+	if ( (t = (FANT_PERF_THREAD*)calloc(1, sizeof(FANT_PERF_THREAD))) == NULL)
+		return NULL;
+	for (i=0 ; i<FANT_NO_COUNTERS ; i++)
+	{
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = counter_configs[i];
+		attr.disabled = (i == 0);
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		/* one group (led by the cycles) per thread, any CPU */
+		t->fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, (i == 0) ? -1 : t->fd[0], 0);
+		if ( (t->fd[i] < 0) && (error == 0) )
+			error = errno;
+		if ( (i == 0) && (t->fd[0] < 0) )
+		{
+			for (i=1 ; i<FANT_NO_COUNTERS ; i++)
+				t->fd[i] = -1;
+			break;
+		}
+	}
+	if (t->fd[0] >= 0)
+		ioctl(t->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+	pthread_mutex_lock(&threads_lock);
+	if (open_error == 0)
+		open_error = error;
+	t->next = threads;
+	threads = t;
+	thread_generation = generation;
+	pthread_mutex_unlock(&threads_lock);
+	return thread = t;
+}
+
+static void read_counts(FANT_PERF_THREAD *t, uint64_t *counts)
+{
+	uint64_t value;
+	int      i;
+
+	for (i=0 ; i<FANT_NO_COUNTERS ; i++)
+	{
+		if ( (t->fd[i] < 0) || (read(t->fd[i], &value, sizeof(value)) != sizeof(value)) )
+			value = 0;
+		counts[i] = value;
+	}
+}
+
+static void write_ratio(FILE *fp, const char *name, double a, double b, int available)
+{
+	if (available && (b > 0.))
+		fprintf(fp, ", \"%s\": %.4f", name, a / b);
+	else
+		fprintf(fp, ", \"%s\": null", name);
+}
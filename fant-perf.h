@@ -0,0 +1,81 @@
+/*
+  ============================================================================
+   File: FANT-PERF.H
+  ============================================================================
+
+             HARDWARE COUNTERS PER DSP KERNEL OF LIBFANT (perf_event_open)
+
+   When started, every call of a DSP kernel of the library (and of the
+   sample conversions of the program) is measured: wall time and, if the
+   kernel permits it (perf_event_paranoid, containers), CPU cycles,
+   instructions, cache references and cache misses of the calling thread.
+   Each thread opens its own counter group at its first measurement and
+   adds to its own totals; fant_perf_write() adds up all threads and has
+   to be called after they have finished. It writes a JSON report with
+   per kernel: variant (fant-kern.h), calls, samples, ns/sample,
+   cycles/sample, IPC and cache miss rate (null if the counter is not
+   available).
+
+   History:
+   p1a  18-10-26   basic version
+   p1b  18-10-26   kernel variant in the report
+
+  ============================================================================
+*/
+#ifndef FANT_PERF_defined
+#define FANT_PERF_defined 100
+
+#include <stdint.h>
+
+enum { FANT_K_HQ,          /* hq_kernel() (FIR) */
+       FANT_K_IIR,         /* cascade_iir_kernel() */
+       FANT_K_AWEIGHT,     /* AWeightFil() */
+       FANT_K_DC,          /* DCOffsetFil() */
+       FANT_K_VOLTMETER,   /* speech_voltmeter() */
+       FANT_K_SH2FL,       /* sh2fl_16bit() */
+       FANT_K_FL2SH,       /* fl2sh_16bit() */
+       FANT_NO_KERNELS };
+
+#define FANT_NO_COUNTERS  4   /* cycles, instructions, cache references, misses */
+
+typedef struct {
+	long     calls;
+	double   samples;
+	double   time;
+	uint64_t counts[FANT_NO_COUNTERS];
+} FANT_PERF_KERNEL;
+
+typedef struct FANT_PERF_THREAD {
+	int                      fd[FANT_NO_COUNTERS];  /* -1 if not available */
+	FANT_PERF_KERNEL         kernels[FANT_NO_KERNELS];
+	struct FANT_PERF_THREAD *next;
+} FANT_PERF_THREAD;
+
+/* state at the begin of a kernel call */
+typedef struct {
+	double   time;
+	uint64_t counts[FANT_NO_COUNTERS];
+} FANT_PERF_SNAP;
+
+extern int fant_perf_on;
+
+void fant_perf_start(void);
+void fant_perf_begin(FANT_PERF_SNAP *snap);
+void fant_perf_end(FANT_PERF_SNAP *snap, int kernel, long no_samples);
+int  fant_perf_write(const char *path);
+
+/* nearly free if not measuring */
+#define FANT_PERF_BEGIN(snap) \
+	do { if (fant_perf_on) fant_perf_begin(snap); } while (0)
+#define FANT_PERF_END(snap, kernel, no_samples) \
+	do { if (fant_perf_on) fant_perf_end(snap, kernel, no_samples); } while (0)
+
+/* one measured statement, e.g. FANT_PERF_CALL(FANT_K_DC, n, DCOffsetFil(x, n, 8000)) */
+#define FANT_PERF_CALL(kernel, no_samples, ...) \
+	do { FANT_PERF_SNAP perf_snap_; \
+	     FANT_PERF_BEGIN(&perf_snap_); \
+	     __VA_ARGS__; \
+	     FANT_PERF_END(&perf_snap_, kernel, no_samples); } while (0)
+
+#endif /* FANT_PERF_defined */
+/* ........................ End of FANT-PERF.H ......................... */
@@ -0,0 +1,182 @@
+/*
+********************************************************************************
+*
+*      File             : fant-plan.c
+*      Tested Platforms : Linux-OS
+*      Description      : Processing plan of libfant: the bits of
+*                         FANT_PARAMS.mode are resolved once into the
+*                         measurement chains of S and N, the output filter
+*                         and the gain and mix stage (see FANT_PLAN in
+*                         fant.h), which fant_process() runs without
+*                         decoding the mode again. fant_plan_print()
+*                         describes the stages (filter_add_noise --explain).
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*      p1b  18-10-26                   32 and 48 kHz data
+*      p1c  18-10-26                   float outputs
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "fant.h"
+
+static void downsample_chain(FANT_CHAIN*, int);
+static void print_chain(const FANT_CHAIN*, FILE*);
+
+/*=====================================================================*/
+
+/* the branches of the former speech_level(), filter_noise() and noise_level() */
+void fant_plan_compile(const FANT_PARAMS *pars, FANT_PLAN *plan)
+{
+	int mode = pars->mode;
+
+	memset(plan, 0, sizeof(FANT_PLAN));
+	plan->speech.pre = plan->noise.pre = NONE;
+	plan->speech.pre_decim = plan->noise.pre_decim = 1;
+	plan->speech.filter = plan->noise.filter = NONE;
+	plan->speech.dc_decim = plan->noise.dc_decim = 1;
+	plan->speech.volt_decim = plan->noise.volt_decim = 1;
+	if (mode & (SAMP16K | SAMP32K | SAMP48K))  /*  16 kHz data (or downsampled to 16 kHz)  */
+	{
+		plan->rate = 16000;
+		if (mode & SNR_4khz)  /*  full 4 kHz bandwidth: downsampling  16 --> 8 kHz  */
+			plan->speech.filter = plan->noise.filter = DOWN;
+		else if (mode & A_WEIGHT)
+			plan->speech.aweight = plan->noise.aweight = 16000;
+		else if (!(mode & SNR_8khz))  /*  G.712 filtering of 16 K data  */
+			plan->speech.filter = plan->noise.filter = G712_16K;
+
+		if (mode & SNR_8khz)  /* FULL 8 kHz bandwidth */
+		{
+			plan->speech.volt_rate = 16000;
+			if (mode & DC_COMP)
+				plan->speech.dc_comp = 16000;
+		}
+		else
+		{
+			plan->speech.volt_rate = 8000;
+			plan->speech.volt_decim = 2;
+			plan->speech.dc_decim = 2;
+			if ( (mode & DC_COMP) && !(mode & A_WEIGHT) )
+				plan->speech.dc_comp = 8000;
+		}
+
+		if ( (mode & DC_COMP) && ( (mode & SNR_4khz) || !(mode & A_WEIGHT) ) )
+		{
+			if ( (mode & SNR_4khz) || !(mode & SNR_8khz) )
+			{
+				plan->noise.dc_comp = 8000;
+				plan->noise.dc_decim = 2;
+			}
+			else
+				plan->noise.dc_comp = 16000;
+		}
+		if (mode & SNR_8khz)
+			plan->noise.volt_rate = 16000;
+		else  /* noise level from downsampled 8 kHz data */
+		{
+			plan->noise.volt_rate = 8000;
+			plan->noise.volt_decim = 2;
+		}
+	}
+	else  /*  8 kHz data  */
+	{
+		plan->rate = 8000;
+		if (mode & A_WEIGHT)  /* filtering with A-weighting curve */
+			plan->speech.aweight = plan->noise.aweight = 8000;
+		else if (!(mode & SNR_4khz))  /* If NOT full 4 kHz bandwidth --> G.712 filtering  */
+			plan->speech.filter = plan->noise.filter = G712;
+		if ( (mode & DC_COMP) && !(mode & A_WEIGHT) )
+			plan->speech.dc_comp = plan->noise.dc_comp = 8000;
+		plan->speech.volt_rate = plan->noise.volt_rate = 8000;
+	}
+
+	/* 32 and 48 kHz: the chains of 16 kHz data behind a downsampling */
+	if (mode & (SAMP32K | SAMP48K))
+	{
+		plan->rate = (mode & SAMP48K) ? 48000 : 32000;
+		downsample_chain(&plan->speech, plan->rate);
+		downsample_chain(&plan->noise, plan->rate);
+	}
+
+	plan->filter_type = (mode & FILTER) ? pars->filter_type : NONE;
+	plan->norm = (mode & NORM) != 0;
+	plan->norm_level = pars->norm_level;
+	plan->add = (mode & ADD) != 0;
+	plan->snr_range = (mode & SNRANGE) != 0;
+	plan->snr = pars->snr;
+	plan->snr_width = pars->snr_range;
+	plan->float_out = (mode & FLOAT_OUT) != 0;
+}
+
+static void downsample_chain(FANT_CHAIN *c, int rate)
+{
+	c->pre = (rate == 48000) ? DOWN_3 : DOWN;
+	c->pre_decim = rate / 16000;
+	c->dc_decim *= c->pre_decim;
+	c->volt_decim *= c->pre_decim;
+}
+
+void fant_plan_print(const FANT_PLAN *plan, FILE *fp)
+{
+	static const char *filters[] = { "G.712", "P.341", "IRS", "MIRS", "G.712 (16 kHz)", "P.341 (16 kHz)",
+	                                 "MIRS (48 kHz)" };
+
+	fprintf(fp, "processing plan (%d kHz data):\n", plan->rate/1000);
+	fprintf(fp, "  measurement of S: ");
+	print_chain(&plan->speech, fp);
+	if (plan->add)
+	{
+		fprintf(fp, "  measurement of N: ");
+		print_chain(&plan->noise, fp);
+	}
+	fprintf(fp, "  output chain:     %s filter%s\n",
+		(plan->filter_type == NONE) ? "no" : filters[plan->filter_type],
+		(plan->add && (plan->filter_type != NONE)) ? " (noise filtered once)" : "");
+	fprintf(fp, "  gain and mix:     ");
+	if (plan->norm)
+		fprintf(fp, "normalization to %.2f dB", plan->norm_level);
+	else
+		fprintf(fp, "no normalization");
+	if (!plan->add)
+		fprintf(fp, ", no noise\n");
+	else if (plan->snr == NONE)
+		fprintf(fp, ", noise at the SNR of each job\n");
+	else if (plan->snr_range)
+		fprintf(fp, ", noise at a SNR of %.2f ... %.2f dB\n", plan->snr, plan->snr + plan->snr_width);
+	else
+		fprintf(fp, ", noise at a SNR of %.2f dB\n", plan->snr);
+	if (plan->float_out)
+		fprintf(fp, "  quantize:         none, float32 outputs (overload only reported)\n");
+	else
+		fprintf(fp, "  quantize:         overload correction -> 16 bit\n");
+}
+
+static void print_chain(const FANT_CHAIN *c, FILE *fp)
+{
+	int decim = c->pre_decim * ( ( (c->filter == DOWN) || (c->filter == G712_16K) ) ? 2 : 1);
+
+	if (c->pre != NONE)
+		fprintf(fp, "downsampling %d -> 16 kHz -> ", 16*c->pre_decim);
+	if (c->filter == DOWN)
+		fprintf(fp, "downsampling 16 -> 8 kHz -> ");
+	else if (c->filter == G712)
+		fprintf(fp, "G.712 filter -> ");
+	else if (c->filter == G712_16K)
+		fprintf(fp, "G.712 filter (16 -> 8 kHz) -> ");
+	else if (c->aweight)
+		fprintf(fp, "A-weighting (%d kHz) -> ", c->aweight/1000);
+	/* samples/2 of the undecimated signal: its 1st half */
+	if (c->dc_comp)
+		fprintf(fp, "DC compensation (%d kHz%s) -> ", c->dc_comp/1000,
+			(c->dc_decim > decim) ? ", 1st half" : "");
+	fprintf(fp, "P.56 voltmeter (%d kHz%s)\n", c->volt_rate/1000,
+		(c->volt_decim > decim) ? ", 1st half" : "");
+}
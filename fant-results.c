@@ -0,0 +1,222 @@
+/*
+********************************************************************************
+*
+*      File             : fant-results.c
+*      Tested Platforms : Linux-OS
+*      Description      : Per-file result records in JSONL or CSV (see
+*                         fant-results.h). A record is formatted when it is
+*                         added and kept until all records of earlier entries
+*                         have been written.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fant.h"
+#include "fant-stats.h"
+#include "fant-results.h"
+
+#define RESULTS_BUFFER  (1048576)    /* stdio buffer of the results file */
+
+static char skipped[1];              /* marks a skipped entry in "pending" */
+
+static int  store(FANT_RESULTS*, long, char*);
+static void write_string(FILE*, const char*, const char*);
+static void write_number(FILE*, const char*, double, int, int, int);
+
+/*=====================================================================*/
+
+/***  create the results file, CSV if its name ends in ".csv"  ***/
+FANT_RESULTS *fant_results_open(const char *path)
+{
+	FANT_RESULTS *results;
+	size_t        n = strlen(path);
+	int           i;
+
+	if ( (results = (FANT_RESULTS*)calloc(1, sizeof(FANT_RESULTS))) == NULL)
+		return NULL;
+	if ( (results->fp = fopen(path, "w")) == NULL)
+	{
+		free(results);
+		return NULL;
+	}
+	setvbuf(results->fp, NULL, _IOFBF, RESULTS_BUFFER);
+	results->csv = (n >= 4) && (strcmp(path+n-4, ".csv") == 0);
+	if (results->csv)
+	{
+		fprintf(results->fp, "entry,input,output,status,samples,speech_level,activity,"
+			"noise_level,start,snr,overload,seconds");
+		for (i=0 ; i<FANT_NO_STAGES ; i++)
+			fprintf(results->fp, ",time_%s", fant_stage_names[i]);
+		fprintf(results->fp, "\n");
+	}
+	return results;
+}
+
+/***  record of one entry, written as soon as its predecessors are  ***/
+int fant_results_add(FANT_RESULTS *results, long entry, FANT_RESULT_RECORD *rec)
+{
+	FANT_RESULT *res = rec->res;
+	FILE        *fp;
+	char        *line = NULL;
+	size_t       len = 0;
+	int          csv = results->csv, ok = (res != NULL), noise = ok && rec->noise, i;
+
+	if ( (fp = open_memstream(&line, &len)) == NULL)
+		return FANT_ERR_MEMORY;
+	fprintf(fp, csv ? "%ld" : "{\"entry\": %ld", entry);
+	write_string(fp, csv ? NULL : "input", rec->input);
+	write_string(fp, csv ? NULL : "output", rec->output);
+	write_string(fp, csv ? NULL : "status", ok ? "ok" : rec->error);
+	write_number(fp, "samples", (double)rec->no_samples, 0, 1, csv);
+	write_number(fp, "speech_level", ok ? res->speech_level : 0., 4, ok, csv);
+	write_number(fp, "activity", ok ? res->activity : 0., 2, ok, csv);
+	write_number(fp, "noise_level", noise ? res->noise_level : 0., 4, noise, csv);
+	write_number(fp, "start", noise ? (double)res->start : 0., 0, noise && !res->noise_short, csv);
+	write_number(fp, "snr", noise ? res->snr : 0., 4, noise, csv);
+	write_number(fp, "overload", ok ? res->overload : 0., 4, ok, csv);
+	write_number(fp, "seconds", rec->wall, 6, 1, csv);
+	if (!csv)
+		fprintf(fp, ", \"stages\": {");
+	for (i=0 ; i<FANT_NO_STAGES ; i++)
+	{
+		if (csv)
+			write_number(fp, NULL, ok ? res->time[i] : 0., 6, ok, 1);
+		else
+			fprintf(fp, (ok ? "%s\"%s\": %.6f" : "%s\"%s\": null"), (i > 0) ? ", " : "",
+				fant_stage_names[i], ok ? res->time[i] : 0.);
+	}
+	fprintf(fp, csv ? "\n" : "}}\n");
+	if (fclose(fp) != 0)
+	{
+		free(line);
+		return FANT_ERR_MEMORY;
+	}
+	return store(results, entry, line);
+}
+
+/***  entry without record  ***/
+int fant_results_skip(FANT_RESULTS *results, long entry)
+{
+	return store(results, entry, skipped);
+}
+
+/***  write the records (of entries without gaps), the handle is freed  ***/
+int fant_results_close(FANT_RESULTS *results)
+{
+	long i;
+	int  ret = results->error ? FANT_ERR_IO : FANT_OK;
+
+	for (i=0 ; i<results->max_pending ; i++)
+	{
+		if ( (results->pending[i] != NULL) && (results->pending[i] != skipped) )
+		{
+			/* records after a missing entry are lost */
+			ret = FANT_ERR_PARAM;
+			free(results->pending[i]);
+		}
+	}
+	if (fclose(results->fp) != 0)
+		ret = FANT_ERR_IO;
+	free(results->pending);
+	free(results);
+	return ret;
+}
+
+/*=====================================================================*/
+
+/* keep a record and write all records that are complete in order */
+static int store(FANT_RESULTS *results, long entry, char *line)
+{
+	char **pending;
+	long   k = entry - results->next, n;
+
+	if (k < 0)
+	{
+		if (line != skipped)
+			free(line);
+		return FANT_ERR_PARAM;
+	}
+	if (k >= results->max_pending)
+	{
+		n = (k >= 2*results->max_pending) ? k+64 : 2*results->max_pending;
+		if ( (pending = (char**)realloc(results->pending, (size_t)n*sizeof(char*))) == NULL)
+		{
+			if (line != skipped)
+				free(line);
+			return FANT_ERR_MEMORY;
+		}
+		memset(pending+results->max_pending, 0, (size_t)(n-results->max_pending)*sizeof(char*));
+		results->pending = pending;
+		results->max_pending = n;
+	}
+	results->pending[k] = line;
+
+	for (n=0 ; (n < results->max_pending) && (results->pending[n] != NULL) ; n++)
+	{
+		if (results->pending[n] != skipped)
+		{
+			if (fputs(results->pending[n], results->fp) == EOF)
+				results->error = 1;
+			free(results->pending[n]);
+		}
+	}
+	if (n > 0)
+	{
+		memmove(results->pending, results->pending+n, (size_t)(results->max_pending-n)*sizeof(char*));
+		memset(results->pending+results->max_pending-n, 0, (size_t)n*sizeof(char*));
+		results->next += n;
+	}
+	return results->error ? FANT_ERR_IO : FANT_OK;
+}
+
+/* a string field, quoted for JSON (with "name") or for CSV (name NULL) */
+static void write_string(FILE *fp, const char *name, const char *s)
+{
+	if (name == NULL)
+	{
+		fputs(",\"", fp);
+		for ( ; *s ; s++)
+		{
+			if (*s == '"')
+				fputc('"', fp);
+			fputc(*s, fp);
+		}
+		fputc('"', fp);
+		return;
+	}
+	fprintf(fp, ", \"%s\": \"", name);
+	for ( ; *s ; s++)
+	{
+		if ( (*s == '"') || (*s == '\\') )
+			fprintf(fp, "\\%c", *s);
+		else if ((unsigned char)*s < 0x20)
+			fprintf(fp, "\\u%04x", (unsigned char)*s);
+		else
+			fputc(*s, fp);
+	}
+	fputc('"', fp);
+}
+
+/* a number field, null (JSON) or empty (CSV) if not defined */
+static void write_number(FILE *fp, const char *name, double value, int digits,
+	int defined, int csv)
+{
+	if (csv)
+		fputc(',', fp);
+	else
+		fprintf(fp, ", \"%s\": ", name);
+	if (defined)
+		fprintf(fp, "%.*f", digits, value);
+	else if (!csv)
+		fputs("null", fp);
+}
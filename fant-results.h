@@ -0,0 +1,60 @@
+/*
+  ============================================================================
+   File: FANT-RESULTS.H
+  ============================================================================
+
+            PER-FILE RESULT RECORDS OF FILTER_ADD_NOISE (--results)
+
+   One record per processed (or failed) file, as JSON lines
+
+     {"entry": 0, "input": "a.raw", "output": "b.raw", "status": "ok",
+      "samples": 18431, "speech_level": -27.1, "activity": 61.2,
+      "noise_level": -31.5, "start": 1200, "snr": 10.0, "overload": 0.4,
+      "seconds": 0.0123, "stages": {"read": ..., ..., "write": ...}}
+
+   or, if the file name ends in ".csv", as CSV with a header line and the
+   columns entry, input, output, status, samples, speech_level, activity,
+   noise_level, start, snr, overload, seconds and one column per stage
+   (time_read, ...). Values not defined for a file (no noise added, noise
+   shorter than the speech, failed file) are null or empty; "status" is
+   "ok" or the reason of the failure. Levels are in dB, times in seconds.
+
+   Records are numbered by their entry in the list and written in this
+   order, whatever order they are added in; a record that is not to be
+   written (e.g. skipped with --resume) has to be passed to
+   fant_results_skip(). The file is written through a large buffer.
+
+  ============================================================================
+*/
+#ifndef FANT_RESULTS_defined
+#define FANT_RESULTS_defined 100
+
+#include <stdio.h>
+#include "fant.h"
+
+typedef struct {
+	const char  *input;
+	const char  *output;
+	const char  *error;       /* reason of the failure, NULL if processed */
+	long         no_samples;
+	int          noise;       /* noise added */
+	FANT_RESULT *res;         /* NULL if failed */
+	double       wall;        /* seconds of the whole file */
+} FANT_RESULT_RECORD;
+
+typedef struct {
+	FILE   *fp;
+	int     csv;
+	long    next;             /* entry of the next record to be written */
+	char  **pending;          /* formatted records of entries next, next+1, ... */
+	long    max_pending;
+	int     error;
+} FANT_RESULTS;
+
+FANT_RESULTS *fant_results_open(const char *path);
+int  fant_results_add(FANT_RESULTS *results, long entry, FANT_RESULT_RECORD *rec);
+int  fant_results_skip(FANT_RESULTS *results, long entry);
+int  fant_results_close(FANT_RESULTS *results);
+
+#endif /* FANT_RESULTS_defined */
+/* ....................... End of FANT-RESULTS.H ....................... */
@@ -0,0 +1,365 @@
+/*
+********************************************************************************
+*
+*      File             : fant-serve.c
+*      Tested Platforms : Linux-OS
+*      Description      : Server mode of filter_add_noise (option --serve).
+*                         The noise signals, their filtered copies and the
+*                         processing parameters stay resident in one
+*                         FANT_CONTEXT; clients send mix requests over a
+*                         UNIX stream socket (protocol see fant-serve.h).
+*                         Each connection is served by its own thread.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*      p1b  18-10-26                   WAV files (fant-wav.c)
+*      p1c  18-10-26                   big endian raw inputs
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "fant.h"
+#include "fant-serve.h"
+#include "fant-wav.h"
+
+typedef struct {
+	FANT_CONTEXT    *ctx;
+	FILE            *fp_log;
+	int              big_endian;   /* raw inputs are big endian */
+	pthread_mutex_t  log_lock;
+	int              fd;           /* listening socket */
+	volatile int     stop;
+	pthread_mutex_t  con_lock;     /* protects the following members */
+	pthread_cond_t   con_done;
+	int             *con_fd;       /* sockets of open connections */
+	int              no_con;
+	int              max_con;
+} SERVER;
+
+typedef struct {
+	SERVER *srv;
+	int     fd;
+} CONNECTION;
+
+static volatile sig_atomic_t got_signal = 0;
+
+static void *serve_connection(void*);
+static void  serve_mix(SERVER*, char*, FILE*, FILE*);
+static void  stop_handler(int);
+static int   add_connection(SERVER*, int);
+static void  remove_connection(SERVER*, int);
+
+/*=====================================================================*/
+
+int fant_serve(FANT_CONTEXT *ctx, char *path, int big_endian, FILE *fp_log)
+{
+	SERVER             srv;
+	CONNECTION        *con;
+	struct sockaddr_un addr;
+	struct sigaction   sa;
+	pthread_t          thread;
+	int                fd;
+
+	if (strlen(path) >= sizeof(addr.sun_path))
+	{
+		fprintf(stderr, "\nsocket path %s too long\n", path);
+		return FANT_ERR_PARAM;
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+	if ( (srv.fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+	{
+		perror("socket");
+		return FANT_ERR_IO;
+	}
+	unlink(path);
+	if ( (bind(srv.fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) || (listen(srv.fd, 64) < 0) )
+	{
+		fprintf(stderr, "\ncannot listen on socket %s\n", path);
+		close(srv.fd);
+		return FANT_ERR_IO;
+	}
+	srv.ctx = ctx;
+	srv.fp_log = fp_log;
+	srv.big_endian = big_endian;
+	srv.stop = 0;
+	srv.con_fd = NULL;
+	srv.no_con = srv.max_con = 0;
+	pthread_mutex_init(&srv.log_lock, NULL);
+	pthread_mutex_init(&srv.con_lock, NULL);
+	pthread_cond_init(&srv.con_done, NULL);
+
+	/* SIGINT/SIGTERM interrupt accept() to remove the socket */
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = stop_handler;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	fprintf(fp_log, "Serving requests on %s\n", path);
+	fflush(fp_log);
+	while (!srv.stop && !got_signal)
+	{
+		if ( (fd = accept(srv.fd, NULL, NULL)) < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			break;    /* listening socket shut down by SHUTDOWN */
+		}
+		if ( (con = (CONNECTION*)malloc(sizeof(CONNECTION))) == NULL || add_connection(&srv, fd) != FANT_OK)
+		{
+			free(con);
+			close(fd);
+			continue;
+		}
+		con->srv = &srv;
+		con->fd = fd;
+		if (pthread_create(&thread, NULL, serve_connection, con) != 0)
+		{
+			remove_connection(&srv, fd);
+			close(fd);
+			free(con);
+			continue;
+		}
+		pthread_detach(thread);
+	}
+	close(srv.fd);
+	unlink(path);
+
+	/* finish the running requests, idle connections see end of input */
+	pthread_mutex_lock(&srv.con_lock);
+	for (fd=0 ; fd<srv.no_con ; fd++)
+		shutdown(srv.con_fd[fd], SHUT_RD);
+	while (srv.no_con > 0)
+		pthread_cond_wait(&srv.con_done, &srv.con_lock);
+	pthread_mutex_unlock(&srv.con_lock);
+	free(srv.con_fd);
+	pthread_cond_destroy(&srv.con_done);
+	pthread_mutex_destroy(&srv.con_lock);
+	pthread_mutex_destroy(&srv.log_lock);
+	fprintf(fp_log, "Server on %s stopped\n", path);
+	return FANT_OK;
+}
+
+static int add_connection(SERVER *srv, int fd)
+{
+	int *buf;
+
+	pthread_mutex_lock(&srv->con_lock);
+	if (srv->no_con == srv->max_con)
+	{
+		if ( (buf = (int*)realloc(srv->con_fd, (srv->max_con+16)*sizeof(int))) == NULL)
+		{
+			pthread_mutex_unlock(&srv->con_lock);
+			return FANT_ERR_MEMORY;
+		}
+		srv->con_fd = buf;
+		srv->max_con += 16;
+	}
+	srv->con_fd[srv->no_con++] = fd;
+	pthread_mutex_unlock(&srv->con_lock);
+	return FANT_OK;
+}
+
+static void remove_connection(SERVER *srv, int fd)
+{
+	int i;
+
+	pthread_mutex_lock(&srv->con_lock);
+	for (i=0 ; i<srv->no_con ; i++)
+	{
+		if (srv->con_fd[i] == fd)
+		{
+			srv->con_fd[i] = srv->con_fd[--srv->no_con];
+			break;
+		}
+	}
+	pthread_cond_signal(&srv->con_done);
+	pthread_mutex_unlock(&srv->con_lock);
+}
+
+static void stop_handler(int sig)
+{
+	got_signal = 1;
+}
+
+/*=====================================================================*/
+
+static void *serve_connection(void *arg)
+{
+	CONNECTION *con = (CONNECTION*)arg;
+	SERVER     *srv = con->srv;
+	FILE       *fp_in = NULL, *fp_out = NULL;
+	char       *line = NULL;
+	size_t      len = 0;
+	int         fd, con_fd = con->fd;
+
+	free(con);
+	if ( (fd = dup(con_fd)) < 0 || (fp_out = fdopen(fd, "w")) == NULL || (fp_in = fdopen(con_fd, "r")) == NULL)
+	{
+		if (fp_out != NULL)
+			fclose(fp_out);
+		else if (fd >= 0)
+			close(fd);
+		remove_connection(srv, con_fd);
+		close(con_fd);
+		return NULL;
+	}
+
+	while (getline(&line, &len, fp_in) > 0)
+	{
+		line[strcspn(line, "\r\n")] = '\0';
+		if (strncmp(line, "MIX ", 4) == 0)
+			serve_mix(srv, line+4, fp_in, fp_out);
+		else if (strcmp(line, "QUIT") == 0)
+			break;
+		else if (strcmp(line, "SHUTDOWN") == 0)
+		{
+			srv->stop = 1;
+			shutdown(srv->fd, SHUT_RDWR);
+			fprintf(fp_out, "OK\n");
+			break;
+		}
+		else
+			fprintf(fp_out, "ERR unknown request\n");
+		fflush(fp_out);
+	}
+	free(line);
+	fclose(fp_out);
+	remove_connection(srv, con_fd);
+	fclose(fp_in);
+	return NULL;
+}
+
+/***  one mix request: "<input> <output> [key=value ...]"  ***/
+static void serve_mix(SERVER *srv, char *args, FILE *fp_in, FILE *fp_out)
+{
+	FANT_REQUEST req;
+	FANT_RESULT  res;
+	FANT_AUDIO   audio;
+	FILE        *fp;
+	char        *input, *output, *tok, *save;
+	short       *buf = NULL;
+	long         no_samples = -1;
+	int          ret;
+
+	fant_default_request(&req);
+	input = strtok_r(args, " \t", &save);
+	output = strtok_r(NULL, " \t", &save);
+	if (input == NULL || output == NULL)
+	{
+		fprintf(fp_out, "ERR missing input or output\n");
+		return;
+	}
+	while ( (tok = strtok_r(NULL, " \t", &save)) != NULL)
+	{
+		if (strncmp(tok, "snr=", 4) == 0)
+			req.snr = atof(tok+4);
+		else if (strncmp(tok, "seed=", 5) == 0)
+			req.seed = atol(tok+5);
+		else if (strncmp(tok, "start=", 6) == 0)
+			req.start = atol(tok+6);
+		else if (strncmp(tok, "noise=", 6) == 0)
+			req.noise_id = atoi(tok+6);
+		else if (strncmp(tok, "n=", 2) == 0)
+			no_samples = atol(tok+2);
+		else
+		{
+			fprintf(fp_out, "ERR unknown parameter %s\n", tok);
+			return;
+		}
+	}
+
+	/* load samples of speech signal */
+	if (strcmp(input, "-") == 0)
+	{
+		if (no_samples < 0)
+		{
+			fprintf(fp_out, "ERR inline samples need n=<samples>\n");
+			return;
+		}
+		if ( (buf = (short*)malloc((size_t)(no_samples+1)*sizeof(short))) == NULL)
+		{
+			fprintf(fp_out, "ERR %s\n", fant_strerror(FANT_ERR_MEMORY));
+			return;
+		}
+		if (fread(buf, sizeof(short), (size_t)no_samples, fp_in) != (size_t)no_samples)
+		{
+			fprintf(fp_out, "ERR incomplete samples\n");
+			free(buf);
+			return;
+		}
+	}
+	else if ( (fp = fopen(input, "r")) == NULL)
+	{
+		fprintf(fp_out, "ERR cannot open speech file %s\n", input);
+		return;
+	}
+	else
+	{
+		ret = fant_read_audio(fp, 0, srv->big_endian, &audio);
+		fclose(fp);
+		if ( (ret == FANT_OK) && (audio.rate > 0) && (audio.rate != srv->ctx->plan.rate) )
+		{
+			fant_audio_free(&audio);
+			ret = FANT_ERR_RATE;
+		}
+		if (ret != FANT_OK)
+		{
+			fprintf(fp_out, "ERR %s\n", fant_strerror(ret));
+			return;
+		}
+		buf = audio.samples;
+		no_samples = audio.no_samples;
+	}
+
+	if ( (ret = fant_process_short(srv->ctx, buf, buf, no_samples, &req, &res)) != FANT_OK)
+	{
+		fprintf(fp_out, "ERR %s\n", fant_strerror(ret));
+		free(buf);
+		return;
+	}
+
+	if (strcmp(output, "-") != 0)
+	{
+		if ( (fp = fopen(output, "w")) == NULL)
+		{
+			fprintf(fp_out, "ERR cannot open output file %s\n", output);
+			free(buf);
+			return;
+		}
+		if (fant_write_audio(fp, buf, no_samples, fant_wav_name(output) ? srv->ctx->plan.rate : 0) != FANT_OK)
+		{
+			fprintf(fp_out, "ERR could not write all samples to file %s\n", output);
+			fclose(fp);
+			free(buf);
+			return;
+		}
+		fclose(fp);
+	}
+	fprintf(fp_out, "OK s-level=%.2f n-level=%.2f start=%ld snr=%.2f overload=%.2f samples=%ld\n",
+		res.speech_level, res.noise_level, res.noise_short ? -1 : res.start, res.snr, res.overload, no_samples);
+	if (strcmp(output, "-") == 0)
+		fwrite(buf, sizeof(short), (size_t)no_samples, fp_out);
+	free(buf);
+
+	pthread_mutex_lock(&srv->log_lock);
+	fprintf(srv->fp_log, " file:%s  s-level:%6.2f  n-level:%6.2f  SNR:%f\n",
+		input, res.speech_level, res.noise_level, res.snr);
+	pthread_mutex_unlock(&srv->log_lock);
+}
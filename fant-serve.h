@@ -0,0 +1,34 @@
+/*
+  ============================================================================
+   File: FANT-SERVE.H
+  ============================================================================
+
+                   SERVER MODE OF FILTER_ADD_NOISE (--serve)
+
+   Protocol (one text line per request on a UNIX stream socket):
+
+     MIX <input> <output> [snr=<dB>] [seed=<n>] [start=<n>] [noise=<id>]
+         input  : raw SHORT file (big endian if fant_serve() is started
+                  with big_endian) or "-" for n=<samples> inline samples
+                  following the request line
+         output : raw SHORT file or "-" to return the samples inline
+     QUIT        closes the connection
+     SHUTDOWN    stops the server
+
+   Reply:
+     OK s-level=<dB> n-level=<dB> start=<n> snr=<dB> overload=<f> samples=<n>
+        (followed by the samples if output is "-")
+     ERR <message>
+
+  ============================================================================
+*/
+#ifndef FANT_SERVE_defined
+#define FANT_SERVE_defined 100
+
+#include <stdio.h>
+#include "fant.h"
+
+int fant_serve(FANT_CONTEXT *ctx, char *path, int big_endian, FILE *fp_log);
+
+#endif /* FANT_SERVE_defined */
+/* ........................ End of FANT-SERVE.H ........................ */
@@ -0,0 +1,122 @@
+/*
+********************************************************************************
+*
+*      File             : fant-stats.c
+*      Tested Platforms : Linux-OS
+*      Description      : Timing statistics of a run (see fant-stats.h). Per
+*                         file only the stage times are added and the wall
+*                         time is stored; sorting and output are done once
+*                         at the end.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fant.h"
+#include "fant-stats.h"
+
+const char *fant_stage_names[FANT_NO_STAGES] = {
+	"read", "convert", "measure_filter", "voltmeter", "output_filter", "noise", "overload", "write" };
+
+static int    compare_doubles(const void*, const void*);
+static double percentile(double*, long, double);
+
+/*=====================================================================*/
+
+FANT_STATS *fant_stats_init(void)
+{
+	FANT_STATS *stats;
+
+	if ( (stats = (FANT_STATS*)calloc(1, sizeof(FANT_STATS))) == NULL)
+		return NULL;
+	stats->start = fant_time();
+	return stats;
+}
+
+/***  times of one processed file  ***/
+void fant_stats_add(FANT_STATS *stats, FANT_RESULT *res, long no_samples, double wall)
+{
+	double *latency;
+	int     i;
+
+	for (i=0 ; i<FANT_NO_STAGES ; i++)
+		stats->stage[i] += res->time[i];
+	stats->no_samples += (double)no_samples;
+	if (stats->no_files == stats->max_files)
+	{
+		/* without memory only the latencies are incomplete */
+		if ( (latency = (double*)realloc(stats->latency,
+			(size_t)(stats->max_files+4096)*sizeof(double))) == NULL)
+			return;
+		stats->latency = latency;
+		stats->max_files += 4096;
+	}
+	stats->latency[stats->no_files++] = wall;
+}
+
+int fant_stats_write(FANT_STATS *stats, const char *path, double sample_rate)
+{
+	FILE   *fp;
+	double  wall = fant_time() - stats->start;
+	double  audio = stats->no_samples / sample_rate;
+	int     i;
+
+	if ( (fp = fopen(path, "w")) == NULL)
+		return FANT_ERR_IO;
+	qsort(stats->latency, (size_t)stats->no_files, sizeof(double), compare_doubles);
+	fprintf(fp, "{\"files\": %ld, \"samples\": %.0f, \"audio_seconds\": %.3f, \"wall_seconds\": %.6f,\n",
+		stats->no_files, stats->no_samples, audio, wall);
+	fprintf(fp, " \"samples_per_second\": %.1f, \"real_time_factor\": %.6f,\n",
+		(wall > 0.) ? stats->no_samples / wall : 0., (audio > 0.) ? wall / audio : 0.);
+	fprintf(fp, " \"stages\": {");
+	for (i=0 ; i<FANT_NO_STAGES ; i++)
+		fprintf(fp, "%s\n  \"%s\": {\"seconds\": %.6f, \"percent\": %.2f}", (i > 0) ? "," : "",
+			fant_stage_names[i], stats->stage[i], (wall > 0.) ? 100. * stats->stage[i] / wall : 0.);
+	fprintf(fp, "},\n \"file_latency\": {\"p50\": %.6f, \"p95\": %.6f, \"p99\": %.6f, \"max\": %.6f}}\n",
+		percentile(stats->latency, stats->no_files, 50.), percentile(stats->latency, stats->no_files, 95.),
+		percentile(stats->latency, stats->no_files, 99.), percentile(stats->latency, stats->no_files, 100.));
+	if (fclose(fp) != 0)
+		return FANT_ERR_IO;
+	return FANT_OK;
+}
+
+void fant_stats_free(FANT_STATS *stats)
+{
+	if (stats == NULL)
+		return;
+	free(stats->latency);
+	free(stats);
+}
+
+/*=====================================================================*/
+
+/* nearest rank of sorted values */
+static double percentile(double *sorted, long n, double p)
+{
+	long rank;
+
+	if (n == 0)
+		return 0.;
+	rank = (long)(p / 100. * (double)n + 0.999999);
+	if (rank < 1)
+		rank = 1;
+	if (rank > n)
+		rank = n;
+	return sorted[rank-1];
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
@@ -0,0 +1,43 @@
+/*
+  ============================================================================
+   File: FANT-STATS.H
+  ============================================================================
+
+                 TIMING STATISTICS OF A RUN OF FILTER_ADD_NOISE (--stats)
+
+   The stage times of every processed file (FANT_RESULT.time) and its
+   wall time are summed up; at the end a JSON summary is written:
+
+     {"files": ..., "samples": ..., "audio_seconds": ..., "wall_seconds": ...,
+      "samples_per_second": ..., "real_time_factor": ...,
+      "stages": {"read": {"seconds": ..., "percent": ...}, ...},
+      "file_latency": {"p50": ..., "p95": ..., "p99": ..., "max": ...}}
+
+   Percentages refer to the wall time of the run, the real-time factor
+   is the wall time divided by the duration of the speech.
+
+  ============================================================================
+*/
+#ifndef FANT_STATS_defined
+#define FANT_STATS_defined 100
+
+#include "fant.h"
+
+typedef struct {
+	double  start;                     /* fant_time() of the run */
+	double  stage[FANT_NO_STAGES];
+	double  no_samples;
+	double *latency;                   /* wall time per file */
+	long    no_files;
+	long    max_files;
+} FANT_STATS;
+
+extern const char *fant_stage_names[FANT_NO_STAGES];   /* as in the JSON summary */
+
+FANT_STATS *fant_stats_init(void);
+void fant_stats_add(FANT_STATS *stats, FANT_RESULT *res, long no_samples, double wall);
+int  fant_stats_write(FANT_STATS *stats, const char *path, double sample_rate);
+void fant_stats_free(FANT_STATS *stats);
+
+#endif /* FANT_STATS_defined */
+/* ........................ End of FANT-STATS.H ........................ */
@@ -0,0 +1,51 @@
+/*
+  ============================================================================
+   File: FANT-STREAM.H
+  ============================================================================
+
+                 FRAMED STREAM MODE OF FILTER_ADD_NOISE (--stream)
+
+   stdin carries a sequence of frames, each a FANT_FRAME_IN header followed
+   by "no_samples" raw SHORT samples. For every input frame one frame is
+   written to stdout in the same order: a FANT_FRAME_OUT header followed
+   by the processed samples. All fields are in host byte order.
+   If processing of a frame fails, "status" holds the (negative) error code
+   and no samples follow the header.
+
+  ============================================================================
+*/
+#ifndef FANT_STREAM_defined
+#define FANT_STREAM_defined 100
+
+#include <stdint.h>
+
+#define FANT_FRAME_IN_MAGIC   "FNTI"
+#define FANT_FRAME_OUT_MAGIC  "FNTO"
+
+/* flags of an input frame: which of the optional fields are valid */
+#define FANT_FRAME_SNR     0x1
+#define FANT_FRAME_SEED    0x2
+#define FANT_FRAME_START   0x4
+
+typedef struct {
+	char     magic[4];      /* FANT_FRAME_IN_MAGIC */
+	int32_t  no_samples;
+	int32_t  flags;
+	float    snr;           /* SNR in dB (FANT_FRAME_SNR) */
+	int32_t  seed;          /* seed of the noise segment (FANT_FRAME_SEED) */
+	int32_t  start;         /* 1st noise sample (FANT_FRAME_START) */
+} FANT_FRAME_IN;
+
+typedef struct {
+	char     magic[4];      /* FANT_FRAME_OUT_MAGIC */
+	int32_t  no_samples;
+	int32_t  status;        /* FANT_OK or error code */
+	float    speech_level;  /* S before normalization */
+	float    noise_level;
+	int32_t  start;         /* 1st noise sample, -1 if noise too short */
+	float    snr;
+	float    overload;      /* max. amplitude before overload correction */
+} FANT_FRAME_OUT;
+
+#endif /* FANT_STREAM_defined */
+/* ....................... End of FANT-STREAM.H ........................ */
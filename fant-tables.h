@@ -0,0 +1,64 @@
+/*
+  ============================================================================
+   File: FANT-TABLES.H
+  ============================================================================
+
+               GENERATED FIR COEFFICIENT TABLES OF LIBFANT
+
+   fant-tables.c is written at build time by fant_gentab (see the make
+   files), which runs the initializations of the ITU-T STL FIR filters and
+   emits their coefficients as they end up in SCD_FIR.h0 (scaled by the
+   gain of fir_initialization()) as static const tables, aligned to
+   FANT_TABLE_ALIGN bytes and zero padded to a multiple of
+   FANT_TABLE_PAD coefficients, so that vector loads never cross the end.
+   The coefficients are written as hexadecimal floats, so the tables are
+   bit-exact copies of what the STL computes.
+
+   fant_fir_init() makes a filter from a table: only the struct and the
+   delay line are allocated (in one block), the coefficients are shared
+   and never copied or scaled. Such a filter is freed with fant_fir_free()
+   and never with hq_free().
+
+   History:
+   p1a  18-10-26   basic version
+
+  ============================================================================
+*/
+#ifndef FANT_TABLES_defined
+#define FANT_TABLES_defined 100
+
+#include "firflt.h"
+
+#define FANT_TABLE_ALIGN  64
+#define FANT_TABLE_PAD    16   /* floats of one vector block */
+
+/* in the order of fant_fir_tables[] */
+enum { FANT_T_DOWN_2_TO_1,       /* hq_down_2_to_1_init() */
+       FANT_T_UP_1_TO_2,         /* hq_up_1_to_2_init() */
+       FANT_T_DOWN_3_TO_1,       /* hq_down_3_to_1_init() */
+       FANT_T_UP_1_TO_3,         /* hq_up_1_to_3_init() */
+       FANT_T_LP_PB_2_TO_1,      /* linear_phase_pb_2_to_1_init() */
+       FANT_T_LP_PB_1_TO_2,      /* linear_phase_pb_1_to_2_init() */
+       FANT_T_HP_8KHZ,           /* fir_hp_8khz_init() (P.341 at 8 kHz) */
+       FANT_T_IRS_8KHZ,          /* irs_8khz_init() */
+       FANT_T_IRS_16KHZ,         /* irs_16khz_init() */
+       FANT_T_MOD_IRS_16KHZ,     /* mod_irs_16khz_init() */
+       FANT_T_MOD_IRS_48KHZ,     /* mod_irs_48khz_init() */
+       FANT_T_P341_16KHZ,        /* p341_16khz_init() */
+       FANT_NO_FIR_TABLES };
+
+typedef struct {
+	const char  *name;     /* of the STL initialization */
+	long         lenh0;    /* number of coefficients (without padding) */
+	long         dwn_up;   /* down- or upsampling factor */
+	char         hswitch;  /* 'U': upsampling, else downsampling */
+	const float *h0;       /* scaled coefficients */
+} FANT_FIR_TABLE;
+
+extern const FANT_FIR_TABLE fant_fir_tables[FANT_NO_FIR_TABLES];
+
+SCD_FIR *fant_fir_init(int table);
+void     fant_fir_free(SCD_FIR *fir_ptr);
+
+#endif /* FANT_TABLES_defined */
+/* ....................... End of FANT-TABLES.H ........................ */
@@ -0,0 +1,187 @@
+/*
+********************************************************************************
+*
+*      File             : fant-trace.c
+*      Tested Platforms : Linux-OS
+*      Description      : Per-thread ring buffers of spans and their output
+*                         as Chrome trace events (see fant-trace.h).
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "fant.h"
+#include "fant-trace.h"
+
+int fant_trace_on = 0;
+
+static long             ring_size;
+static double           trace_start;
+static FANT_TRACE_RING *rings;
+static int              no_rings;
+static pthread_mutex_t  rings_lock = PTHREAD_MUTEX_INITIALIZER;
+static int              generation;       /* of the rings, per start */
+static __thread FANT_TRACE_RING *ring;
+static __thread int              ring_generation;
+
+static FANT_TRACE_RING *thread_ring(void);
+static void write_string(FILE*, const char*);
+
+/*=====================================================================*/
+
+/***  start recording with "size" spans per thread  ***/
+int fant_trace_start(long size)
+{
+	if (size < 1)
+		return FANT_ERR_PARAM;
+	ring_size = size;
+	generation++;
+	trace_start = fant_time();
+	fant_trace_on = 1;
+	return FANT_OK;
+}
+
+/***  span of "file" (NULL: the current file of the thread)  ***/
+void fant_trace_span(const char *name, const char *file, double start, double end)
+{
+	FANT_TRACE_RING *r;
+	FANT_TRACE_SPAN *span;
+
+	if ( !fant_trace_on || ( (r = thread_ring()) == NULL) )
+		return;
+	span = &r->spans[r->no_spans % ring_size];
+	span->name = name;
+	span->start = start;
+	span->duration = end - start;
+	if (file == NULL)
+		file = r->file;
+	/* the end of a long path is more telling */
+	if (strlen(file) >= FANT_TRACE_ARG)
+		file += strlen(file) - (FANT_TRACE_ARG-1);
+	strcpy(span->arg, file);
+	r->no_spans++;
+}
+
+/***  file of the following spans of this thread  ***/
+void fant_trace_file(const char *file)
+{
+	FANT_TRACE_RING *r;
+
+	if ( !fant_trace_on || ( (r = thread_ring()) == NULL) )
+		return;
+	if (strlen(file) >= FANT_TRACE_ARG)
+		file += strlen(file) - (FANT_TRACE_ARG-1);
+	strcpy(r->file, file);
+}
+
+/***  name of this thread in the trace  ***/
+void fant_trace_thread(const char *name)
+{
+	FANT_TRACE_RING *r;
+
+	if ( !fant_trace_on || ( (r = thread_ring()) == NULL) )
+		return;
+	snprintf(r->thread, sizeof(r->thread), "%s", name);
+}
+
+/***  all rings as Chrome trace events, the rings are freed  ***/
+int fant_trace_write(const char *path)
+{
+	FANT_TRACE_RING *r;
+	FANT_TRACE_SPAN *span;
+	FILE            *fp;
+	long             i, first;
+	int              ret = FANT_OK, comma = 0;
+
+	fant_trace_on = 0;
+	if ( (fp = fopen(path, "w")) == NULL)
+		ret = FANT_ERR_IO;
+	else
+	{
+		fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+		for (r=rings ; r!=NULL ; r=r->next)
+		{
+			fprintf(fp, "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": ",
+				comma ? "," : "", r->tid);
+			write_string(fp, r->thread);
+			fprintf(fp, "}}");
+			comma = 1;
+			first = (r->no_spans > ring_size) ? r->no_spans - ring_size : 0;
+			for (i=first ; i<r->no_spans ; i++)
+			{
+				span = &r->spans[i % ring_size];
+				fprintf(fp, ",\n{\"name\": \"%s\", \"cat\": \"fant\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+					"\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"file\": ",
+					span->name, r->tid, 1e6 * (span->start - trace_start), 1e6 * span->duration);
+				write_string(fp, span->arg);
+				fprintf(fp, "}}");
+			}
+		}
+		fprintf(fp, "\n]}\n");
+		if (fclose(fp) != 0)
+			ret = FANT_ERR_IO;
+	}
+
+	pthread_mutex_lock(&rings_lock);
+	while ( (r = rings) != NULL)
+	{
+		rings = r->next;
+		free(r->spans);
+		free(r);
+	}
+	no_rings = 0;
+	pthread_mutex_unlock(&rings_lock);
+	return ret;
+}
+
+/*=====================================================================*/
+
+/* ring of the calling thread, registered with its first span */
+static FANT_TRACE_RING *thread_ring(void)
+{
+	FANT_TRACE_RING *r, **last;
+
+	if ( (ring != NULL) && (ring_generation == generation) )
+		return ring;
+	if ( (r = (FANT_TRACE_RING*)calloc(1, sizeof(FANT_TRACE_RING))) == NULL)
+		return NULL;
+	if ( (r->spans = (FANT_TRACE_SPAN*)calloc((size_t)ring_size, sizeof(FANT_TRACE_SPAN))) == NULL)
+	{
+		free(r);
+		return NULL;
+	}
+	pthread_mutex_lock(&rings_lock);
+	r->tid = ++no_rings;
+	snprintf(r->thread, sizeof(r->thread), "thread %d", r->tid);
+	for (last=&rings ; *last!=NULL ; last=&(*last)->next)
+		;
+	*last = r;
+	pthread_mutex_unlock(&rings_lock);
+	ring_generation = generation;
+	return ring = r;
+}
+
+static void write_string(FILE *fp, const char *s)
+{
+	putc('"', fp);
+	for ( ; *s ; s++)
+	{
+		if ( (*s == '"') || (*s == '\\') )
+			fprintf(fp, "\\%c", *s);
+		else if ( (unsigned char)*s < 0x20)
+			fprintf(fp, "\\u%04x", (unsigned char)*s);
+		else
+			putc(*s, fp);
+	}
+	putc('"', fp);
+}
@@ -0,0 +1,55 @@
+/*
+  ============================================================================
+   File: FANT-TRACE.H
+  ============================================================================
+
+                  TIMELINE TRACE OF LIBFANT (CHROME TRACE EVENTS)
+
+   When tracing is started, the library, the I/O threads and the program
+   record one span (name, file, start, duration) per processing stage.
+   Every thread writes into its own ring buffer without locking (only the
+   first span of a thread registers its ring); when a ring is full the
+   oldest spans are overwritten. fant_trace_write() writes all rings in
+   the Chrome trace-event format (chrome://tracing, ui.perfetto.dev) and
+   has to be called after all recording threads have finished.
+
+   History:
+   p1a  18-10-26   basic version
+
+  ============================================================================
+*/
+#ifndef FANT_TRACE_defined
+#define FANT_TRACE_defined 100
+
+#define FANT_TRACE_ARG  56     /* max. length of the file name of a span */
+
+typedef struct {
+	const char *name;            /* static string */
+	double      start;           /* fant_time() */
+	double      duration;
+	char        arg[FANT_TRACE_ARG];
+} FANT_TRACE_SPAN;
+
+typedef struct FANT_TRACE_RING {
+	FANT_TRACE_SPAN        *spans;
+	long                    no_spans;     /* recorded, also overwritten ones */
+	int                     tid;          /* in the order of registration */
+	char                    thread[32];   /* name of the thread */
+	char                    file[FANT_TRACE_ARG];  /* current file */
+	struct FANT_TRACE_RING *next;
+} FANT_TRACE_RING;
+
+extern int fant_trace_on;
+
+int  fant_trace_start(long ring_size);
+void fant_trace_span(const char *name, const char *file, double start, double end);
+void fant_trace_file(const char *file);
+void fant_trace_thread(const char *name);
+int  fant_trace_write(const char *path);
+
+/* span of the file set by fant_trace_file(), nearly free if not tracing */
+#define FANT_TRACE(name, start, end) \
+	do { if (fant_trace_on) fant_trace_span(name, NULL, start, end); } while (0)
+
+#endif /* FANT_TRACE_defined */
+/* ........................ End of FANT-TRACE.H ........................ */
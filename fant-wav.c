@@ -0,0 +1,271 @@
+/*
+********************************************************************************
+*
+*      File             : fant-wav.c
+*      Tested Platforms : Linux-OS
+*      Description      : Loading of raw and WAV speech and noise files,
+*                         mapped or read, and writing of raw or WAV outputs
+*                         (see fant-wav.h).
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*      p1b  18-10-26                   float outputs
+*      p1c  18-10-26                   float WAV files on big endian hosts
+*      p1d  18-10-26                   byte order of raw files as parameter
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "fant.h"
+#include "fant-wav.h"
+
+static int  host_big_endian(void);
+static int  parse_wav(const unsigned char*, size_t, int*, size_t*, size_t*);
+static void swap_samples(short*, long);
+static void swap_floats(float*, long);
+static unsigned long get32(const unsigned char*);
+static unsigned int  get16(const unsigned char*);
+static void put32(unsigned char*, unsigned long);
+static void put16(unsigned char*, unsigned int);
+static int  write_header(FILE*, int, unsigned int, unsigned int, unsigned long);
+
+/*=====================================================================*/
+
+int fant_read_audio(FILE *fp, int map, int big_endian, FANT_AUDIO *audio)
+{
+	struct stat    st;
+	unsigned char *bytes = NULL;
+	size_t         len, offset = 0, size;
+	int            wav;
+
+	memset(audio, 0, sizeof(FANT_AUDIO));
+	if (map && (fstat(fileno(fp), &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0) && (ftell(fp) == 0))
+	{
+		/* private mapping: the samples can be swapped in place */
+		bytes = (unsigned char*)mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(fp), 0);
+		if (bytes != (unsigned char*)MAP_FAILED)
+		{
+			audio->map = bytes;
+			audio->map_size = (size_t)st.st_size;
+		}
+	}
+	if (audio->map != NULL)
+		len = audio->map_size;
+	else
+	{
+		if ( (audio->samples = fant_read_raw(fp, &audio->no_samples)) == NULL)
+			return FANT_ERR_MEMORY;
+		bytes = (unsigned char*)audio->samples;
+		len = (size_t)audio->no_samples * sizeof(short);
+	}
+
+	/* chunks are word aligned, an odd data offset is a corrupt file */
+	if ( ( (wav = parse_wav(bytes, len, &audio->rate, &offset, &size)) < 0) || (offset & 1) )
+	{
+		fant_audio_free(audio);
+		return FANT_ERR_FORMAT;
+	}
+	if (!wav)
+		size = len;
+	audio->no_samples = (long)(size / sizeof(short));
+	if (audio->map != NULL)
+		audio->samples = (short*)(bytes + offset);
+	else if (offset > 0)
+		memmove(audio->samples, bytes + offset, (size_t)audio->no_samples * sizeof(short));
+
+	if (wav ? host_big_endian() : (big_endian && !host_big_endian()))
+		swap_samples(audio->samples, audio->no_samples);
+	return FANT_OK;
+}
+
+void fant_audio_free(FANT_AUDIO *audio)
+{
+	if (audio->map != NULL)
+		munmap(audio->map, audio->map_size);
+	else
+		free(audio->samples);
+	audio->samples = NULL;
+	audio->map = NULL;
+}
+
+/***  1: WAV file, 0: raw samples, -1: unsupported WAV file  ***/
+static int parse_wav(const unsigned char *p, size_t len, int *rate, size_t *offset, size_t *size)
+{
+	size_t       pos = 12, chunk;
+	unsigned int format;
+	int          fmt = 0;
+
+	if ( (len < 12) || (memcmp(p, "RIFF", 4) != 0) || (memcmp(p+8, "WAVE", 4) != 0) )
+		return 0;
+	while (pos + 8 <= len)
+	{
+		chunk = get32(p+pos+4);
+		if (memcmp(p+pos, "fmt ", 4) == 0)
+		{
+			if ( (chunk < 16) || (pos + 8 + 16 > len) )
+				return -1;
+			format = get16(p+pos+8);
+			if ( (format == 0xFFFE) && (chunk >= 40) && (pos + 8 + 40 <= len) )
+				format = get16(p+pos+8+24);  /* WAVE_FORMAT_EXTENSIBLE: sub format */
+			if ( (format != 1) || (get16(p+pos+10) != 1) || (get16(p+pos+22) != 16) )
+				return -1;  /* 16 bit PCM mono only */
+			*rate = (int)get32(p+pos+12);
+			fmt = 1;
+		}
+		else if (memcmp(p+pos, "data", 4) == 0)
+		{
+			if (!fmt)
+				return -1;
+			*offset = pos + 8;
+			/* size 0 or beyond the end: written to a pipe, up to the end */
+			*size = ( (chunk == 0) || (chunk > len - *offset) ) ? len - *offset : chunk;
+			return 1;
+		}
+		pos += 8 + chunk + (chunk & 1);
+	}
+	return -1;
+}
+
+/*=====================================================================*/
+
+int fant_wav_name(const char *name)
+{
+	size_t len = strlen(name);
+
+	return (len >= 4) && (strcasecmp(name + len - 4, ".wav") == 0);
+}
+
+int fant_write_audio(FILE *fp, const short *buf, long no_samples, int rate)
+{
+	unsigned long bytes = (unsigned long)no_samples * sizeof(short);
+	short        *swapped = NULL;
+	int           ret = FANT_OK;
+
+	if (rate > 0)
+	{
+		if (write_header(fp, rate, 1, 16, bytes) != FANT_OK)  /* PCM */
+			return FANT_ERR_IO;
+		if (host_big_endian())
+		{
+			if ( (swapped = (short*)malloc((size_t)bytes + 1)) == NULL)
+				return FANT_ERR_MEMORY;
+			memcpy(swapped, buf, (size_t)bytes);
+			swap_samples(swapped, no_samples);
+			buf = swapped;
+		}
+	}
+	if (fwrite(buf, sizeof(short), (size_t)no_samples, fp) != (size_t)no_samples)
+		ret = FANT_ERR_IO;
+	free(swapped);
+	return ret;
+}
+
+/***  no quantization: samples in -1 ... 1, beyond on overload  ***/
+int fant_write_float(FILE *fp, const float *buf, long no_samples, int rate)
+{
+	unsigned long bytes = (unsigned long)no_samples * sizeof(float);
+	float        *swapped = NULL;
+	int           ret = FANT_OK;
+
+	if (rate > 0)
+	{
+		if (write_header(fp, rate, 3, 32, bytes) != FANT_OK)  /* IEEE float */
+			return FANT_ERR_IO;
+		if (host_big_endian())
+		{
+			if ( (swapped = (float*)malloc((size_t)bytes + 1)) == NULL)
+				return FANT_ERR_MEMORY;
+			memcpy(swapped, buf, (size_t)bytes);
+			swap_floats(swapped, no_samples);
+			buf = swapped;
+		}
+	}
+	if (fwrite(buf, sizeof(float), (size_t)no_samples, fp) != (size_t)no_samples)
+		ret = FANT_ERR_IO;
+	free(swapped);
+	return ret;
+}
+
+/***  44 bytes: RIFF, fmt and data chunk of a mono file  ***/
+static int write_header(FILE *fp, int rate, unsigned int format, unsigned int bits, unsigned long bytes)
+{
+	unsigned char header[FANT_WAV_HEADER];
+
+	memcpy(header, "RIFF", 4);
+	put32(header+4, 36 + bytes);
+	memcpy(header+8, "WAVEfmt ", 8);
+	put32(header+16, 16);
+	put16(header+20, format);
+	put16(header+22, 1);  /* mono */
+	put32(header+24, (unsigned long)rate);
+	put32(header+28, (unsigned long)rate * bits/8);
+	put16(header+32, bits/8);
+	put16(header+34, bits);
+	memcpy(header+36, "data", 4);
+	put32(header+40, bytes);
+	return (fwrite(header, 1, FANT_WAV_HEADER, fp) == FANT_WAV_HEADER) ? FANT_OK : FANT_ERR_IO;
+}
+
+/*=====================================================================*/
+
+static int host_big_endian(void)
+{
+	const short one = 1;
+
+	return *(const char*)&one == 0;
+}
+
+static void swap_samples(short *buf, long no_samples)
+{
+	unsigned short *u = (unsigned short*)buf;
+	long            i;
+
+	for (i=0 ; i<no_samples ; i++)
+		u[i] = (unsigned short)( (u[i] >> 8) | (u[i] << 8) );
+}
+
+static void swap_floats(float *buf, long no_samples)
+{
+	unsigned char *p = (unsigned char*)buf, t;
+	long           i;
+
+	for (i=0 ; i<no_samples ; i++, p+=4)
+	{
+		t = p[0]; p[0] = p[3]; p[3] = t;
+		t = p[1]; p[1] = p[2]; p[2] = t;
+	}
+}
+
+static unsigned long get32(const unsigned char *p)
+{
+	return (unsigned long)p[0] | ( (unsigned long)p[1] << 8) | ( (unsigned long)p[2] << 16) | ( (unsigned long)p[3] << 24);
+}
+
+static unsigned int get16(const unsigned char *p)
+{
+	return (unsigned int)p[0] | ( (unsigned int)p[1] << 8);
+}
+
+static void put32(unsigned char *p, unsigned long v)
+{
+	p[0] = (unsigned char)(v & 0xff);
+	p[1] = (unsigned char)( (v >> 8) & 0xff);
+	p[2] = (unsigned char)( (v >> 16) & 0xff);
+	p[3] = (unsigned char)( (v >> 24) & 0xff);
+}
+
+static void put16(unsigned char *p, unsigned int v)
+{
+	p[0] = (unsigned char)(v & 0xff);
+	p[1] = (unsigned char)( (v >> 8) & 0xff);
+}
@@ -0,0 +1,55 @@
+/*
+  ============================================================================
+   File: FANT-WAV.H
+  ============================================================================
+
+                    WAV AND RAW AUDIO FILES OF LIBFANT
+
+   Speech and noise files are either headerless 16 bit samples (raw) or
+   RIFF/WAVE files with 16 bit PCM mono data, which are recognized by
+   their header. fant_read_audio() returns the samples of the data chunk
+   and the sample rate of the header (0 for raw files). Regular files
+   can be mapped instead of read: the samples then point into the mapping
+   of the file and are converted from there, no buffer is filled. Raw
+   files are in host byte order unless they are read as big endian, then
+   they are byte swapped on loading (as WAV data on big endian hosts).
+
+   Outputs are written raw, or as WAV files if their name ends with
+   ".wav" (fant_wav_name()), either as 16 bit samples or as 32 bit
+   floats (-1 ... 1, WAV format IEEE float) that are not quantized.
+
+   History:
+   p1a  18-10-26   basic version
+   p1b  18-10-26   float outputs
+   p1c  18-10-26   byte order of raw files as parameter
+
+  ============================================================================
+*/
+#ifndef FANT_WAV_defined
+#define FANT_WAV_defined 100
+
+#include <stdio.h>
+
+#define FANT_WAV_HEADER  44  /* bytes of the header written */
+
+typedef struct {
+	short  *samples;     /* in host byte order */
+	long    no_samples;
+	int     rate;        /* of the WAV header, 0 for raw samples */
+	void   *map;         /* mapping of the file, NULL if read into samples */
+	size_t  map_size;
+} FANT_AUDIO;
+
+/* map != 0: map regular files; big_endian != 0: raw files are big endian;
+   FANT_ERR_FORMAT for unsupported WAV files */
+int  fant_read_audio(FILE *fp, int map, int big_endian, FANT_AUDIO *audio);
+/* frees the samples or unmaps the file */
+void fant_audio_free(FANT_AUDIO *audio);
+/* a name ending with ".wav" */
+int  fant_wav_name(const char *name);
+/* raw samples or, for rate > 0, a WAV file of them */
+int  fant_write_audio(FILE *fp, const short *buf, long no_samples, int rate);
+int  fant_write_float(FILE *fp, const float *buf, long no_samples, int rate);
+
+#endif /* FANT_WAV_defined */
+/* ........................ End of FANT-WAV.H .......................... */
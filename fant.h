@@ -0,0 +1,220 @@
+/*
+  ============================================================================
+   File: FANT.H
+  ============================================================================
+
+                 FILTERING AND NOISE ADDING LIBRARY (libfant)
+
+                          GLOBAL FUNCTION PROTOTYPES
+
+   The processing of filter_add_noise as a reentrant library: a context
+   holds the preloaded (and already filtered) noise signals and the
+   processing parameters, a request describes how one utterance is mixed
+   and the result returns the measured levels. No function of this module
+   calls exit(); errors are returned as negative FANT_ERR_... codes.
+   A context is read-only during fant_process() and can therefore be
+   shared by several threads.
+
+   History:
+   p1a  18-10-26   Library version of filter_add_noise.c
+   p1b  18-10-26   output filter per request
+   p1c  18-10-26   known speech level and prefiltered speech per request
+   p1d  18-10-26   processing time per stage
+   p1e  18-10-26   processing plan resolved from the mode once per context
+   p1f  18-10-26   clean speech and scaled noise per request
+   p1g  18-10-26   WAV files (see fant-wav.h)
+   p1h  18-10-26   overload kept for float outputs
+   p1i  18-10-26   32 and 48 kHz data
+   p1j  18-10-26   resampling of noise files (resample_samples())
+   p1k  18-10-26   float outputs in the processing plan (FLOAT_OUT)
+
+  ============================================================================
+*/
+#ifndef FANT_defined
+#define FANT_defined 100
+
+#include <stdio.h>
+#include <pthread.h>
+
+/* processing modes (bitmask in FANT_PARAMS.mode) */
+#define NONE   9999
+#define FILTER 0x1
+#define NORM   0x2
+#define ADD    0x4
+#define SAMP16K    0x8
+#define SNRANGE    0x10
+#define SNR_4khz   0x20
+#define SNR_8khz   0x40
+#define DC_COMP    0x80
+#define IND_LIST   0x100
+#define A_WEIGHT   0x200
+#define SAMP32K    0x400
+#define SAMP48K    0x800
+#define FLOAT_OUT  0x1000  /* float outputs: requests with keep_overload */
+
+/* filter types (DOWN: 2:1, DOWN_3: 3:1 for the measurement chains) */
+enum { G712, P341, IRS, MIRS, G712_16K, P341_16K, MIRS_48K, DOWN, DOWN_3 };
+
+/* return codes */
+#define FANT_OK             0
+#define FANT_ERR_MEMORY    -1
+#define FANT_ERR_PARAM     -2
+#define FANT_ERR_NOISE     -3
+#define FANT_ERR_IO        -4
+#define FANT_ERR_FORMAT    -5
+#define FANT_ERR_RATE      -6
+
+/* request value to be drawn from the random generator */
+#define FANT_RANDOM        -1
+
+/* request value (noise_id) for no noise adding */
+#define FANT_NO_NOISE      -1
+
+/* stages of the processing of one utterance (FANT_RESULT.time), reading
+   and writing are timed by the caller                                   */
+enum { FANT_T_READ,       /* loading of the speech samples */
+       FANT_T_CONVERT,    /* short <-> float (fant_process_short()) */
+       FANT_T_MEASURE,    /* filtering for the speech level S */
+       FANT_T_VOLTMETER,  /* DC compensation and P.56 speech voltmeter */
+       FANT_T_FILTER,     /* output filter */
+       FANT_T_NOISE,      /* normalization, noise level N and mixing */
+       FANT_T_OVERLOAD,   /* overload check and correction */
+       FANT_T_WRITE,      /* writing of the output */
+       FANT_NO_STAGES };
+
+/* number of output filter types (G712 ... MIRS_48K) */
+#define FANT_NO_FILTERS    (MIRS_48K+1)
+
+
+/* processing parameters shared by all requests of a context */
+typedef struct {
+	int    mode;
+	int    filter_type;
+	float  norm_level;
+	float  snr;
+	float  snr_range;
+} FANT_PARAMS;
+
+/* measurement chain of the speech level S or of the noise level N:
+   downsampling of 32 or 48 kHz data to 16 kHz, filter (or
+   A-weighting), DC compensation and P.56 voltmeter                 */
+typedef struct {
+	int    pre;         /* filter_samples() type to 16 kHz (DOWN, DOWN_3) or NONE */
+	int    pre_decim;   /* decimation of "pre" (1 without) */
+	int    filter;      /* filter_samples() type (G712, G712_16K, DOWN) or NONE */
+	int    aweight;     /* sampling frequency of the A-weighting or 0 */
+	int    dc_comp;     /* sampling frequency of the DC compensation or 0 */
+	int    dc_decim;    /* DC compensation of no_samples/dc_decim samples
+	                       (decimation of "pre" included)              */
+	int    volt_rate;   /* sampling frequency of the voltmeter */
+	int    volt_decim;  /* voltmeter on no_samples/volt_decim samples */
+} FANT_CHAIN;
+
+/* processing plan, the stages resolved from FANT_PARAMS.mode once by
+   fant_plan_compile() (done by fant_init() for the context)           */
+typedef struct {
+	int         rate;         /* sampling frequency of the data */
+	FANT_CHAIN  speech;       /* measurement of S */
+	FANT_CHAIN  noise;        /* measurement of N (noise filtered once) */
+	int         filter_type;  /* output filter or NONE */
+	int         norm;         /* normalization to norm_level */
+	float       norm_level;
+	int         add;          /* noise adding */
+	int         snr_range;    /* SNR drawn from snr ... snr+snr_width */
+	float       snr;
+	float       snr_width;
+	int         float_out;    /* float outputs, neither overload correction
+	                             nor quantization (FLOAT_OUT) */
+} FANT_PLAN;
+
+/* noise signal, loaded and filtered once */
+typedef struct {
+	long   no_samples;
+	float *noise;        /* filtered with the output filter (if FILTER) */
+	float *noise_g712;   /* filtered for calculating the noise level N */
+	float *noise_filter[FANT_NO_FILTERS];
+	                     /* filtered with the output filters added by
+	                        fant_add_filter() (NULL if not added) */
+} FANT_NOISE;
+
+typedef struct {
+	FANT_PARAMS      pars;
+	FANT_PLAN        plan;
+	FANT_NOISE      *noises;
+	int              no_noises;
+	int              filters;    /* bitmask of added output filters */
+	unsigned int     seed;       /* state of the context generator */
+	pthread_mutex_t  seed_lock;
+} FANT_CONTEXT;
+
+/* parameters of one utterance */
+typedef struct {
+	int    noise_id;     /* noise as returned by fant_add_noise()
+	                        or FANT_NO_NOISE */
+	long   start;        /* 1st noise sample or FANT_RANDOM */
+	double snr;          /* SNR in dB or NONE for the context SNR (range) */
+	long   seed;         /* seed of a private generator or FANT_RANDOM
+	                        to draw from the generator of the context */
+	int    filter_type;  /* output filter or NONE for the filter of the
+	                        context, others need fant_add_filter() */
+	double speech_level; /* S if already known (e.g. cached) or NONE */
+	int    prefiltered;  /* speech already filtered with the output
+	                        filter (needs speech_level) */
+	float *clean;        /* buffer (no_samples) for the filtered and
+	                        normalized speech or NULL */
+	float *noise;        /* buffer (no_samples) for the scaled noise
+	                        (zeros without noise) or NULL; both are
+	                        scaled by the overload correction as the
+	                        output, which is their sum (up to the
+	                        rounding of the correction) */
+	int    keep_overload; /* no overload correction, the samples beyond
+	                        -1 ... 1 are kept for float outputs and only
+	                        reported (FANT_RESULT.overload) */
+} FANT_REQUEST;
+
+/* levels measured while processing one utterance */
+typedef struct {
+	double speech_level;  /* S before normalization */
+	double noise_level;   /* N of the noise segment before scaling */
+	long   start;         /* 1st noise sample used */
+	int    noise_short;   /* noise shorter than speech, used repeatedly */
+	double snr;           /* SNR applied */
+	double overload;      /* max. amplitude before overload correction */
+	double activity;      /* activity factor of the speech in % (0 if
+	                         the speech level was given) */
+	double time[FANT_NO_STAGES];  /* seconds per stage */
+} FANT_RESULT;
+
+
+/* context handling */
+FANT_CONTEXT *fant_init(FANT_PARAMS *pars, unsigned int seed);
+void fant_free(FANT_CONTEXT *ctx);
+int  fant_add_noise(FANT_CONTEXT *ctx, float *noise, long no_samples);
+int  fant_add_noise_short(FANT_CONTEXT *ctx, short *noise, long no_samples);
+int  fant_add_filter(FANT_CONTEXT *ctx, int filter_type);
+
+/* processing plan */
+void fant_plan_compile(const FANT_PARAMS *pars, FANT_PLAN *plan);
+void fant_plan_print(const FANT_PLAN *plan, FILE *fp);
+
+/* processing of one utterance */
+void fant_default_request(FANT_REQUEST *req);
+int  fant_process(FANT_CONTEXT *ctx, float *speech, long no_samples,
+                  FANT_REQUEST *req, FANT_RESULT *res);
+int  fant_process_short(FANT_CONTEXT *ctx, short *in, short *out, long no_samples,
+                        FANT_REQUEST *req, FANT_RESULT *res);
+int  fant_speech_level(FANT_CONTEXT *ctx, float *speech, long no_samples,
+                       double *level, double *activity);
+const char *fant_strerror(int err);
+double fant_time(void);
+short *fant_read_short(FILE *fp, int big_endian, long *no_samples);  /* raw or WAV */
+short *fant_read_raw(FILE *fp, long *no_samples);
+
+/* filtering */
+int  filter_samples(float *signal, long no_samples, int type);
+int  resample_samples(float **signal, long *no_samples, int from, int to);
+void DCOffsetFil(float *signal, long no_samples, int samp_freq);
+int  AWeightFil(float *signal, long no_samples, int samp_freq);
+
+#endif /* FANT_defined */
+/* ........................... End of FANT.H ........................... */
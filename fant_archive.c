@@ -0,0 +1,97 @@
+/*
+********************************************************************************
+*
+*      File             : fant_archive.c
+*      Tested Platforms : Linux-OS
+*      Description      : Reader for the output archives of filter_add_noise
+*                         (--archive, layout see fant-arc.h).
+*                         "list" prints the index of an archive, "extract"
+*                         writes the samples of one record as raw SHORT.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fant.h"
+#include "fant-arc.h"
+
+void print_usage(char*);
+
+/*=====================================================================*/
+
+int  main(int argc, char *argv[])
+{
+	FANT_ARC       *arc;
+	FANT_ARC_ENTRY *entry;
+	FILE           *fp;
+	long            i;
+
+	if (argc < 3)
+		print_usage(argv[0]);
+	if ( (arc = fant_arc_open(argv[2])) == NULL)
+	{
+		fprintf(stderr, "\ncannot open archive %s\n", argv[2]);
+		exit(-1);
+	}
+
+	if (strcmp(argv[1], "list") == 0)
+	{
+		for (i=0 ; i<arc->no_entries ; i++)
+		{
+			entry = &arc->entries[i];
+			printf("%s  samples:%ld  s-level:%6.2f  n-level:%6.2f  1st noise sample:%d  SNR:%f",
+				entry->name, (long)entry->index.no_samples, entry->index.speech_level,
+				entry->index.noise_level, entry->index.start, entry->index.snr);
+			if (entry->index.overload > 1.)
+				printf("  overload:%f", entry->index.overload);
+			printf("\n");
+		}
+	}
+	else if ( (strcmp(argv[1], "extract") == 0) && (argc > 3) )
+	{
+		if ( (entry = fant_arc_find(arc, argv[3])) == NULL)
+		{
+			fprintf(stderr, "\nno record %s in archive %s\n", argv[3], argv[2]);
+			exit(-1);
+		}
+		if ( (argc < 5) || (strcmp(argv[4], "-") == 0) )
+			fp = stdout;
+		else if ( (fp = fopen(argv[4], "w")) == NULL)
+		{
+			fprintf(stderr, "\ncannot open output file %s\n\n", argv[4]);
+			exit(-1);
+		}
+		if (fwrite(fant_arc_samples(arc, entry), sizeof(short), (size_t)entry->index.no_samples, fp)
+			!= (size_t)entry->index.no_samples)
+		{
+			fprintf(stderr, "could not write all samples of record %s!\n", argv[3]);
+			exit(-1);
+		}
+		fclose(fp);
+	}
+	else
+		print_usage(argv[0]);
+
+	fant_arc_free(arc);
+	return 0;
+}
+
+/*=====================================================================*/
+
+void print_usage(char *name)
+{
+	fprintf(stderr,"\nUsage:\t%s list <archive>", name);
+	fprintf(stderr,"\n\t%s extract <archive> <record> [<output>]", name);
+	fprintf(stderr,"\n\n\t(without output or with \"-\" the samples are written to stdout)");
+	fprintf(stderr,"\n");
+	exit(-1);
+}
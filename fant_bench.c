@@ -0,0 +1,569 @@
+/*
+********************************************************************************
+*
+*      File             : fant_bench.c
+*      Tested Platforms : Linux-OS
+*      Description      : Microbenchmark of the DSP kernels of libfant
+*                         (make -f fant_bench.make bench-kernels).
+*                         Every filter_samples() type, AWeightFil() and
+*                         DCOffsetFil() at 8 and 16 kHz, speech_voltmeter(),
+*                         the 16 bit conversions and the noise adding and
+*                         overload stages of fant_process() are run on
+*                         synthetic signals of several lengths; ns/sample
+*                         (best and median run) and samples/s are written
+*                         as JSON, so that builds can be compared.
+*                         With -c a corpus of speech-like files with a
+*                         log-normal length distribution and a long noise
+*                         are synthesized and filter_add_noise is run on
+*                         it in batch and pipeline mode and with the
+*                         measurement and filter options; files/s, real-time
+*                         factor, file latency and peak RSS are reported
+*                         (make -f fant_bench.make bench-corpus).
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*      p1b  18-10-26                   corpus benchmark of filter_add_noise
+*      p1c  18-10-26                   choice of the kernel variants (-k)
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "ugst-utl.h"
+#include "sv-p56.h"
+#include "fant.h"
+#include "fant-kern.h"
+
+#define MAX_LENGTHS  16
+#define MAX_RUNS     1000
+#define MIN_RUNS     3
+#define MAX_ARGS     64
+#define NOISE_SECONDS   300     /* of the synthesized noise */
+#define PIPELINE_FILES  20      /* files processed one by one in pipeline mode */
+
+/* kernels besides the filter_samples() types */
+enum { K_FILTER, K_AWEIGHT, K_DC, K_VOLTMETER, K_SH2FL, K_FL2SH, K_NOISE, K_OVERLOAD };
+
+typedef struct {
+	const char *name;
+	int         kernel;
+	int         type;       /* filter type or sampling frequency */
+} BENCH_CASE;
+
+static const BENCH_CASE cases[] = {
+	{ "filter_samples/g712",     K_FILTER,    G712 },
+	{ "filter_samples/p341",     K_FILTER,    P341 },
+	{ "filter_samples/irs",      K_FILTER,    IRS },
+	{ "filter_samples/mirs",     K_FILTER,    MIRS },
+	{ "filter_samples/g712_16k", K_FILTER,    G712_16K },
+	{ "filter_samples/p341_16k", K_FILTER,    P341_16K },
+	{ "filter_samples/down",     K_FILTER,    DOWN },
+	{ "AWeightFil/8000",         K_AWEIGHT,   8000 },
+	{ "AWeightFil/16000",        K_AWEIGHT,   16000 },
+	{ "DCOffsetFil/8000",        K_DC,        8000 },
+	{ "DCOffsetFil/16000",       K_DC,        16000 },
+	{ "speech_voltmeter/8000",   K_VOLTMETER, 8000 },
+	{ "speech_voltmeter/16000",  K_VOLTMETER, 16000 },
+	{ "sh2fl_16bit",             K_SH2FL,     0 },
+	{ "fl2sh_16bit",             K_FL2SH,     0 },
+	{ "fant_process/noise",      K_NOISE,     0 },
+	{ "fant_process/overload",   K_OVERLOAD,  0 } };
+
+#define NO_CASES  (int)(sizeof(cases)/sizeof(cases[0]))
+
+static long   lengths[MAX_LENGTHS] = { 160, 1600, 16000, 160000 };
+static int    no_lengths = 4;
+static double min_time = 0.1;   /* seconds per case and length */
+
+/* runs of filter_add_noise on the corpus (options besides -n, -s, -r, -e) */
+typedef struct {
+	const char *name;
+	const char *options;
+	int         samp16k;    /* configuration for 16 kHz data */
+} CORPUS_CONFIG;
+
+static const CORPUS_CONFIG configs[] = {
+	{ "batch",               "",                      0 },
+	{ "batch_sync",          "--prefetch 0",          0 },
+	{ "batch_16k",           "-u",                    1 },
+	{ "snr_4khz",            "-m snr_4khz",           0 },
+	{ "a_weight",            "-m a_weight",           0 },
+	{ "dc_comp",             "-d",                    0 },
+	{ "snr_4khz_16k",        "-u -m snr_4khz",        1 },
+	{ "snr_8khz_16k",        "-u -m snr_8khz",        1 },
+	{ "a_weight_16k",        "-u -m a_weight",        1 },
+	{ "dc_comp_16k",         "-u -d",                 1 },
+	{ "g712",                "-f g712",               0 },
+	{ "p341",                "-f p341",               0 },
+	{ "irs",                 "-f irs",                0 },
+	{ "mirs",                "-f mirs",               0 },
+	{ "p341_16k",            "-u -f p341",            1 },
+	{ "norm",                "-l -26",                0 } };
+
+#define NO_CONFIGS  (int)(sizeof(configs)/sizeof(configs[0]))
+
+/* lengths (s at 16 kHz) of single files for the peak RSS */
+static const int rss_seconds[] = { 1, 10, 60, 300 };
+#define NO_RSS  (int)(sizeof(rss_seconds)/sizeof(rss_seconds[0]))
+
+void   print_usage(char*);
+void   parse_lengths(char*);
+void   synth_signal(float*, long, unsigned int);
+double run_case(const BENCH_CASE*, FANT_CONTEXT*, int, float*, float*, short*, long);
+int    compare_doubles(const void*, const void*);
+int    compare_longs(const void*, const void*);
+void   corpus_bench(const char*, const char*, int, FILE*);
+void   write_raw(const char*, long, unsigned int);
+double run_program(const char*, const char*, const char*, const char*, long*);
+double stats_value(const char*, const char*);
+
+/*=====================================================================*/
+
+int  main(int argc, char *argv[])
+{
+	FANT_CONTEXT *ctx;
+	FANT_PARAMS   fant_pars;
+	FILE         *fp = stdout;
+	char         *corpus = NULL, *program = "./filter_add_noise", *kernels = getenv("FANT_KERNELS");
+	int           no_files = 100;
+	float        *signal, *work, *noise;
+	short        *shorts;
+	double        runs[MAX_RUNS], total, t;
+	long          max_length = 0, no_noise = 4*160000;
+	int           c, i, j, no_runs, noise_id, first = 1;
+
+	while ( (c = getopt(argc, argv, "l:t:o:c:n:x:k:h")) != -1)
+	{
+		switch (c)
+		{
+		  case 'l':
+			parse_lengths(optarg);
+			break;
+		  case 't':
+			if ( (min_time = atof(optarg)) <= 0.)
+				print_usage(argv[0]);
+			break;
+		  case 'o':
+			if ( (fp = fopen(optarg, "w")) == NULL)
+			{
+				fprintf(stderr, "\ncannot open output file %s\n\n", optarg);
+				exit(-1);
+			}
+			break;
+		  case 'c':
+			corpus = optarg;
+			break;
+		  case 'n':
+			if ( (no_files = atoi(optarg)) <= 0)
+				print_usage(argv[0]);
+			break;
+		  case 'x':
+			program = optarg;
+			break;
+		  case 'k':
+			/* also for filter_add_noise in the corpus benchmark */
+			kernels = optarg;
+			setenv("FANT_KERNELS", optarg, 1);
+			break;
+		  default:
+			print_usage(argv[0]);
+		}
+	}
+	if (fant_kernels_select( (kernels != NULL) ? kernels : "auto") != FANT_OK)
+	{
+		fprintf(stderr, "\nunknown or unsupported kernels %s\n\n", kernels);
+		exit(-1);
+	}
+	if (corpus != NULL)
+	{
+		corpus_bench(corpus, program, no_files, fp);
+		if (fp != stdout)
+			fclose(fp);
+		return 0;
+	}
+	for (i=0 ; i<no_lengths ; i++)
+		max_length = (lengths[i] > max_length) ? lengths[i] : max_length;
+	if (no_noise <= max_length)
+		no_noise = 2*max_length;
+
+	/* noise adding at a fixed SNR, the speech level is given */
+	memset(&fant_pars, 0, sizeof(fant_pars));
+	fant_pars.mode = ADD;
+	fant_pars.filter_type = NONE;
+	fant_pars.snr = 10.;
+	signal = (float*)calloc((size_t)max_length, sizeof(float));
+	work = (float*)calloc((size_t)max_length+1, sizeof(float));
+	noise = (float*)calloc((size_t)no_noise, sizeof(float));
+	shorts = (short*)calloc((size_t)max_length, sizeof(short));
+	if ( (signal == NULL) || (work == NULL) || (noise == NULL) || (shorts == NULL) ||
+	     ( (ctx = fant_init(&fant_pars, 1)) == NULL) )
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+	synth_signal(signal, max_length, 1);
+	synth_signal(noise, no_noise, 2);
+	if ( (noise_id = fant_add_noise(ctx, noise, no_noise)) < 0)
+	{
+		fprintf(stderr, "\ncannot add the noise: %s\n", fant_strerror(noise_id));
+		exit(-1);
+	}
+	fl2sh_16bit(max_length, signal, shorts, 1);
+
+	fprintf(fp, "{\"build\": {\"compiler\": \"%s\", \"date\": \"%s %s\"}, \"kernels\": \"%s\", \"min_seconds\": %g,\n \"results\": [",
+		__VERSION__, __DATE__, __TIME__, fant_kernels.report, min_time);
+	for (i=0 ; i<NO_CASES ; i++)
+	{
+		for (j=0 ; j<no_lengths ; j++)
+		{
+			/* at least MIN_RUNS runs and "min_time" seconds */
+			total = 0.;
+			for (no_runs=0 ; (no_runs < MAX_RUNS) && ( (no_runs < MIN_RUNS) || (total < min_time) ) ; no_runs++)
+			{
+				t = run_case(&cases[i], ctx, noise_id, signal, work, shorts, lengths[j]);
+				runs[no_runs] = t;
+				total += t;
+			}
+			qsort(runs, (size_t)no_runs, sizeof(double), compare_doubles);
+			fprintf(fp, "%s\n  {\"kernel\": \"%s\", \"samples\": %ld, \"runs\": %d, \"ns_per_sample\": %.4f, "
+				"\"ns_per_sample_median\": %.4f, \"samples_per_second\": %.0f}", first ? "" : ",",
+				cases[i].name, lengths[j], no_runs, 1e9 * runs[0] / (double)lengths[j],
+				1e9 * runs[no_runs/2] / (double)lengths[j],
+				(runs[0] > 0.) ? (double)lengths[j] / runs[0] : 0.);
+			first = 0;
+		}
+	}
+	fprintf(fp, "]}\n");
+	if (fp != stdout)
+		fclose(fp);
+	fant_free(ctx);
+	free(signal);
+	free(work);
+	free(noise);
+	free(shorts);
+	return 0;
+}
+
+void print_usage(char *name)
+{
+	fprintf(stderr,"\nUsage:\t%s [Options]\n", name);
+	fprintf(stderr,"\nOptions:");
+	fprintf(stderr,"\n\t-l\t<lengths> of the signals in samples, comma separated");
+	fprintf(stderr,"\n\t\t(default 160,1600,16000,160000)");
+	fprintf(stderr,"\n\t-t\t<seconds> of measurement per kernel and length (default 0.1)");
+	fprintf(stderr,"\n\t-o\t<filename> of the JSON results (default stdout)");
+	fprintf(stderr,"\n\t-c\t<directory> for a synthesized corpus, to benchmark filter_add_noise");
+	fprintf(stderr,"\n\t\ton it instead of the kernels");
+	fprintf(stderr,"\n\t-n\t<number> of files of the corpus (default 100)");
+	fprintf(stderr,"\n\t-x\t<filename> of the filter_add_noise program (default ./filter_add_noise)");
+	fprintf(stderr,"\n\t-k\t<variant> of the kernels: reference, auto (default), scalar, avx2 or avx512");
+	fprintf(stderr,"\n");
+	exit(-1);
+}
+
+/*=====================================================================*/
+
+void parse_lengths(char *arg)
+{
+	char *p = arg, *end;
+
+	for (no_lengths=0 ; *p != '\0' ; no_lengths++)
+	{
+		if (no_lengths == MAX_LENGTHS)
+			print_usage("fant_bench");
+		lengths[no_lengths] = strtol(p, &end, 10);
+		if ( (end == p) || (lengths[no_lengths] <= 0) || ( (*end != ',') && (*end != '\0') ) )
+			print_usage("fant_bench");
+		p = (*end == ',') ? end+1 : end;
+	}
+	if (no_lengths == 0)
+		print_usage("fant_bench");
+}
+
+/* speech-like test signal: modulated harmonics and some noise (-0.5 ... 0.5) */
+void synth_signal(float *buf, long n, unsigned int seed)
+{
+	unsigned int state = seed;
+	double       env, noise;
+	long         i;
+
+	for (i=0 ; i<n ; i++)
+	{
+		state = state * 1103515245u + 12345u;
+		noise = (double)(state >> 8) / (double)(1u << 24) - 0.5;
+		env = 0.5 + 0.5 * sin(2. * M_PI * 3. * (double)i / 8000.);
+		buf[i] = (float)(0.4 * env * (0.5 * sin(2. * M_PI * 220. * (double)i / 8000.) +
+			0.3 * sin(2. * M_PI * 660. * (double)i / 8000.) + 0.2 * sin(2. * M_PI * 1540. * (double)i / 8000.)) +
+			0.1 * noise);
+	}
+}
+
+/***  seconds of one run of a kernel on "n" samples  ***/
+double run_case(const BENCH_CASE *bc, FANT_CONTEXT *ctx, int noise_id, float *signal,
+	float *work, short *shorts, long n)
+{
+	SVP56_state  volt_state;
+	FANT_REQUEST req;
+	FANT_RESULT  res;
+	double       t0, t1;
+
+	/* the kernels work in place, every run gets the same input */
+	memcpy(work, signal, (size_t)n*sizeof(float));
+	t0 = fant_time();
+	switch (bc->kernel)
+	{
+	  case K_FILTER:
+		if (filter_samples(work, n, bc->type) != FANT_OK)
+		{
+			fprintf(stderr, "\ncannot run %s\n", bc->name);
+			exit(-1);
+		}
+		break;
+	  case K_AWEIGHT:
+		AWeightFil(work, n, bc->type);
+		break;
+	  case K_DC:
+		DCOffsetFil(work, n, bc->type);
+		break;
+	  case K_VOLTMETER:
+		init_speech_voltmeter(&volt_state, (double)bc->type);
+		speech_voltmeter(work, n, &volt_state);
+		break;
+	  case K_SH2FL:
+		fant_kernels.sh2fl(n, shorts, work);
+		break;
+	  case K_FL2SH:
+		fant_kernels.fl2sh(n, work, shorts);
+		break;
+	  case K_NOISE:
+	  case K_OVERLOAD:
+		/* stage times as measured by fant_process() */
+		fant_default_request(&req);
+		req.noise_id = noise_id;
+		req.start = 0;
+		req.speech_level = -26.;
+		if (fant_process(ctx, work, n, &req, &res) != FANT_OK)
+		{
+			fprintf(stderr, "\ncannot run %s\n", bc->name);
+			exit(-1);
+		}
+		return res.time[(bc->kernel == K_NOISE) ? FANT_T_NOISE : FANT_T_OVERLOAD];
+	}
+	t1 = fant_time();
+	return t1 - t0;
+}
+
+int compare_doubles(const void *a, const void *b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+
+	return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+int compare_longs(const void *a, const void *b)
+{
+	long x = *(const long*)a, y = *(const long*)b;
+
+	return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+/*=====================================================================*/
+
+/***  corpus benchmark of filter_add_noise  ***/
+void corpus_bench(const char *dir, const char *program, int no_files, FILE *fp)
+{
+	FILE         *fp_in, *fp_out;
+	char          path[1100], in_list[1100], out_list[1100], noise[1100], stats[1100], args[8192];
+	long         *lengths_c, *sorted, total = 0, rss;
+	double       *latency, u1, u2, seconds, wall, audio;
+	unsigned int  state = 12345;
+	int           i, k;
+
+	if ( (mkdir(dir, 0755) != 0) && (errno != EEXIST) )
+	{
+		fprintf(stderr, "\ncannot create corpus directory %s\n\n", dir);
+		exit(-1);
+	}
+	if ( ( (lengths_c = (long*)calloc((size_t)no_files, sizeof(long))) == NULL) ||
+	     ( (sorted = (long*)calloc((size_t)no_files, sizeof(long))) == NULL) ||
+	     ( (latency = (double*)calloc(PIPELINE_FILES, sizeof(double))) == NULL) )
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+
+	/* log-normal lengths (median 3 s, 0.5 ... 20 s at 16 kHz) */
+	snprintf(in_list, sizeof(in_list), "%.1000s/in.list", dir);
+	snprintf(out_list, sizeof(out_list), "%.1000s/out.list", dir);
+	if ( ( (fp_in = fopen(in_list, "w")) == NULL) || ( (fp_out = fopen(out_list, "w")) == NULL) )
+	{
+		fprintf(stderr, "\ncannot write list files in %s\n\n", dir);
+		exit(-1);
+	}
+	for (i=0 ; i<no_files ; i++)
+	{
+		state = state * 1103515245u + 12345u;
+		u1 = ((double)(state >> 8) + 1.) / (double)(1u << 24);
+		state = state * 1103515245u + 12345u;
+		u2 = (double)(state >> 8) / (double)(1u << 24);
+		seconds = 3. * exp(0.6 * sqrt(-2. * log(u1)) * cos(2. * M_PI * u2));
+		seconds = (seconds < 0.5) ? 0.5 : (seconds > 20.) ? 20. : seconds;
+		lengths_c[i] = (long)(seconds * 16000.);
+		total += lengths_c[i];
+		snprintf(path, sizeof(path), "%.1000s/in%04d.raw", dir, i);
+		write_raw(path, lengths_c[i], (unsigned int)i+10);
+		fprintf(fp_in, "%s\n", path);
+		fprintf(fp_out, "%.1000s/out%04d.raw\n", dir, i);
+	}
+	fclose(fp_in);
+	fclose(fp_out);
+	snprintf(noise, sizeof(noise), "%.1000s/noise.raw", dir);
+	write_raw(noise, NOISE_SECONDS*16000L, 2);
+	memcpy(sorted, lengths_c, (size_t)no_files*sizeof(long));
+	qsort(sorted, (size_t)no_files, sizeof(long), compare_longs);
+
+	fprintf(fp, "{\"corpus\": {\"files\": %d, \"samples\": %ld, \"min_samples\": %ld, \"median_samples\": %ld, "
+		"\"max_samples\": %ld, \"noise_samples\": %ld},\n \"configs\": [",
+		no_files, total, sorted[0], sorted[no_files/2], sorted[no_files-1], NOISE_SECONDS*16000L);
+
+	/* batch runs, timed by --stats */
+	snprintf(stats, sizeof(stats), "%.1000s/stats.json", dir);
+	for (k=0 ; k<NO_CONFIGS ; k++)
+	{
+		snprintf(args, sizeof(args), "-i %s -o %s -n %s -s 10 -r 1 -e %.1000s/fant.log --stats %s %s",
+			in_list, out_list, noise, dir, stats, configs[k].options);
+		wall = run_program(program, args, NULL, NULL, &rss);
+		audio = (double)total / (configs[k].samp16k ? 16000. : 8000.);
+		fprintf(fp, "%s\n  {\"name\": \"%s\", \"options\": \"%s\", \"files_per_second\": %.2f, "
+			"\"real_time_factor\": %.6f, \"wall_seconds\": %.3f, \"samples_per_second\": %.0f,\n"
+			"   \"latency\": {\"p50\": %.6f, \"p95\": %.6f, \"p99\": %.6f, \"max\": %.6f}, \"peak_rss_kb\": %ld}",
+			(k > 0) ? "," : "", configs[k].name, configs[k].options, (double)no_files / wall, wall / audio, wall,
+			stats_value(stats, "\"samples_per_second\":"), stats_value(stats, "\"p50\":"),
+			stats_value(stats, "\"p95\":"), stats_value(stats, "\"p99\":"), stats_value(stats, "\"max\":"), rss);
+	}
+
+	/* pipeline: one process per file, latency of the whole process */
+	for (i=0 ; (i < PIPELINE_FILES) && (i < no_files) ; i++)
+	{
+		snprintf(path, sizeof(path), "%.1000s/in%04d.raw", dir, i);
+		snprintf(args, sizeof(args), "-n %s -s 10 -r 1 -e %.1000s/fant.log", noise, dir);
+		latency[i] = run_program(program, args, path, "/dev/null", &rss);
+	}
+	qsort(latency, (size_t)i, sizeof(double), compare_doubles);
+	for (wall=0., k=0 ; k<i ; k++)
+		wall += latency[k];
+	fprintf(fp, ",\n  {\"name\": \"pipeline\", \"options\": \"(stdin to stdout)\", \"files_per_second\": %.2f, "
+		"\"wall_seconds\": %.3f,\n   \"latency\": {\"p50\": %.6f, \"p95\": %.6f, \"p99\": %.6f, \"max\": %.6f}}]",
+		(double)i / wall, wall, latency[i/2], latency[(int)(0.95*(i-1))], latency[(int)(0.99*(i-1))], latency[i-1]);
+
+	/* peak RSS of the pipeline against the input length */
+	fprintf(fp, ",\n \"rss_by_length\": [");
+	for (k=0 ; k<NO_RSS ; k++)
+	{
+		snprintf(path, sizeof(path), "%.1000s/rss%d.raw", dir, rss_seconds[k]);
+		write_raw(path, rss_seconds[k]*16000L, 3);
+		snprintf(args, sizeof(args), "-n %s -u -s 10 -r 1 -e %.1000s/fant.log", noise, dir);
+		wall = run_program(program, args, path, "/dev/null", &rss);
+		fprintf(fp, "%s\n  {\"samples\": %ld, \"wall_seconds\": %.3f, \"peak_rss_kb\": %ld}",
+			(k > 0) ? "," : "", rss_seconds[k]*16000L, wall, rss);
+	}
+	fprintf(fp, "]}\n");
+	free(lengths_c);
+	free(sorted);
+	free(latency);
+}
+
+/* speech-like file of 16 bit samples */
+void write_raw(const char *path, long n, unsigned int seed)
+{
+	FILE  *fp;
+	float *buf;
+	short *shorts;
+
+	if ( ( (buf = (float*)calloc((size_t)n, sizeof(float))) == NULL) ||
+	     ( (shorts = (short*)calloc((size_t)n, sizeof(short))) == NULL) )
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+	synth_signal(buf, n, seed);
+	fl2sh_16bit(n, buf, shorts, 1);
+	if ( ( (fp = fopen(path, "w")) == NULL) || (fwrite(shorts, sizeof(short), (size_t)n, fp) != (size_t)n) ||
+	     (fclose(fp) != 0) )
+	{
+		fprintf(stderr, "\ncannot write file %s\n\n", path);
+		exit(-1);
+	}
+	free(buf);
+	free(shorts);
+}
+
+/***  wall time of a run of the program, its peak RSS in kB in "rss"  ***/
+double run_program(const char *program, const char *args, const char *in, const char *out, long *rss)
+{
+	struct rusage usage;
+	char          buf[8192], *argv[MAX_ARGS], *p;
+	double        t0 = fant_time();
+	pid_t         pid;
+	int           argc = 0, status, fd;
+
+	snprintf(buf, sizeof(buf), "%s", args);
+	argv[argc++] = (char*)program;
+	for (p=strtok(buf, " ") ; (p != NULL) && (argc < MAX_ARGS-1) ; p=strtok(NULL, " "))
+		argv[argc++] = p;
+	argv[argc] = NULL;
+
+	if ( (pid = fork()) < 0)
+	{
+		fprintf(stderr, "\ncannot start %s\n\n", program);
+		exit(-1);
+	}
+	if (pid == 0)
+	{
+		if ( (in != NULL) && ( ( (fd = open(in, O_RDONLY)) < 0) || (dup2(fd, 0) < 0) ) )
+			_exit(127);
+		if ( (out != NULL) && ( ( (fd = open(out, O_WRONLY)) < 0) || (dup2(fd, 1) < 0) ) )
+			_exit(127);
+		execv(program, argv);
+		_exit(127);
+	}
+	if ( (wait4(pid, &status, 0, &usage) != pid) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0) )
+	{
+		fprintf(stderr, "\n%s %s failed\n\n", program, args);
+		exit(-1);
+	}
+	*rss = usage.ru_maxrss;
+	return fant_time() - t0;
+}
+
+/* number following "key" in the statistics file of a run */
+double stats_value(const char *path, const char *key)
+{
+	FILE  *fp;
+	char   buf[8192], *p;
+	size_t n;
+
+	if ( (fp = fopen(path, "r")) == NULL)
+		return 0.;
+	n = fread(buf, 1, sizeof(buf)-1, fp);
+	fclose(fp);
+	buf[n] = '\0';
+	if ( (p = strstr(buf, key)) == NULL)
+		return 0.;
+	return atof(p + strlen(key));
+}
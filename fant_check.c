@@ -0,0 +1,349 @@
+/*
+********************************************************************************
+*
+*      File             : fant_check.c
+*      Tested Platforms : Linux-OS
+*      Description      : Bit-exactness check of the optimized kernels
+*                         (fant-kern.c) against the ITU-T STL reference
+*                         kernels they replace (make -f fant_check.make
+*                         check), every variant of the kernel registry the
+*                         CPU supports; the optimized kernels get the
+*                         coefficients of the generated tables (fant-tables.c),
+*                         so these are checked as well. Both are run with the same random signals
+*                         (full scale, low level, sparse, tiny values) and
+*                         the same segmentation (whole signal, odd fixed and
+*                         random segment lengths) on separate states; the
+*                         number of output samples per call, the maximum
+*                         absolute and ULP difference of the outputs and the
+*                         final state are compared per kernel. The program
+*                         exits with -1 if a kernel exceeds its tolerance
+*                         (FANT_..._ULP).
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*      p1b  18-10-26                   all variants, 16 bit conversions
+*      p1c  18-10-26                   generated coefficient tables
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "ugst-utl.h"
+#include "firflt.h"
+#include "fant-kern.h"
+#include "fant-tables.h"
+
+#define MAX_SEGMENT  1024
+#define NO_SIGNALS   5
+#define NO_PATTERNS  4
+#define SINGLE_SAMPLES  1000  /* segments of 1 sample in pattern 1 */
+
+typedef struct {
+	const char *name;
+	SCD_FIR  *(*init)(void);
+	int        table;       /* generated coefficients (fant-tables.h) */
+} FIR_CASE;
+
+static const FIR_CASE fir_cases[] = {
+	{ "hq_down_2_to_1",        hq_down_2_to_1_init,         FANT_T_DOWN_2_TO_1 },
+	{ "hq_up_1_to_2",          hq_up_1_to_2_init,           FANT_T_UP_1_TO_2 },
+	{ "hq_down_3_to_1",        hq_down_3_to_1_init,         FANT_T_DOWN_3_TO_1 },
+	{ "hq_up_1_to_3",          hq_up_1_to_3_init,           FANT_T_UP_1_TO_3 },
+	{ "linear_phase_pb_2_to_1",linear_phase_pb_2_to_1_init, FANT_T_LP_PB_2_TO_1 },
+	{ "linear_phase_pb_1_to_2",linear_phase_pb_1_to_2_init, FANT_T_LP_PB_1_TO_2 },
+	{ "fir_hp_8khz",           fir_hp_8khz_init,            FANT_T_HP_8KHZ },
+	{ "irs_8khz",              irs_8khz_init,               FANT_T_IRS_8KHZ },
+	{ "irs_16khz",             irs_16khz_init,              FANT_T_IRS_16KHZ },
+	{ "mod_irs_16khz",         mod_irs_16khz_init,          FANT_T_MOD_IRS_16KHZ },
+	{ "mod_irs_48khz",         mod_irs_48khz_init,          FANT_T_MOD_IRS_48KHZ },
+	{ "p341_16khz",            p341_16khz_init,             FANT_T_P341_16KHZ } };
+
+#define NO_FIR_CASES  (int)(sizeof(fir_cases)/sizeof(fir_cases[0]))
+
+/* differences found for one kernel */
+typedef struct {
+	long    calls;
+	long    samples;
+	double  max_abs;
+	long    max_ulp;
+	long    mismatches;   /* of the number of outputs or of the state */
+} CHECK_RESULT;
+
+static unsigned int rand_state;
+
+void  print_usage(char*);
+float next_uniform(void);
+void  make_signal(float*, long, int);
+long  next_segment(int, long, long);
+long  ulp_diff(float, float);
+void  compare(CHECK_RESULT*, float*, float*, long);
+int   check_fir(const FIR_CASE*, FANT_FIR_FN, float*, long, int, CHECK_RESULT*);
+void  check_conv(FANT_SH2FL_FN, FANT_FL2SH_FN, CHECK_RESULT*);
+int   report(const char*, int, CHECK_RESULT*, int);
+
+/*=====================================================================*/
+
+int  main(int argc, char *argv[])
+{
+	CHECK_RESULT res;
+	float       *signal;
+	long         length = 4000;
+	int          c, i, s, p, trials = 1, t, isa, failed = 0;
+
+	rand_state = 1;
+	while ( (c = getopt(argc, argv, "n:l:s:h")) != -1)
+	{
+		switch (c)
+		{
+		  case 'n':
+			if ( (trials = atoi(optarg)) <= 0)
+				print_usage(argv[0]);
+			break;
+		  case 'l':
+			if ( (length = atol(optarg)) <= 0)
+				print_usage(argv[0]);
+			break;
+		  case 's':
+			rand_state = (unsigned int) atol(optarg);
+			break;
+		  default:
+			print_usage(argv[0]);
+		}
+	}
+	if ( (signal = (float*)calloc((size_t)length, sizeof(float))) == NULL)
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+
+	printf("%-24s %-7s %8s %10s %12s %8s %6s\n", "kernel", "isa", "calls", "samples", "max_abs", "max_ulp", "tol");
+	for (isa=FANT_ISA_SCALAR ; isa<FANT_NO_ISAS ; isa++)
+	{
+		if (!fant_isa_supported(isa))
+			continue;
+		for (i=0 ; (fant_fir_variant(isa) != NULL) && (i<NO_FIR_CASES) ; i++)
+		{
+			memset(&res, 0, sizeof(res));
+			for (t=0 ; t<trials ; t++)
+			{
+				for (s=0 ; s<NO_SIGNALS ; s++)
+				{
+					make_signal(signal, length, s);
+					for (p=0 ; p<NO_PATTERNS ; p++)
+					{
+						if (check_fir(&fir_cases[i], fant_fir_variant(isa), signal, length, p, &res) != 0)
+						{
+							fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+							exit(-1);
+						}
+					}
+				}
+			}
+			failed += report(fir_cases[i].name, isa, &res, FANT_FIR_ULP);
+		}
+		if ( (fant_sh2fl_variant(isa) != NULL) && (fant_fl2sh_variant(isa) != NULL) )
+		{
+			memset(&res, 0, sizeof(res));
+			check_conv(fant_sh2fl_variant(isa), fant_fl2sh_variant(isa), &res);
+			failed += report("sh2fl_16bit/fl2sh_16bit", isa, &res, FANT_CONV_ULP);
+		}
+	}
+	free(signal);
+	if (failed > 0)
+	{
+		fprintf(stderr, "\n%d kernels differ from the reference!\n", failed);
+		exit(-1);
+	}
+	return 0;
+}
+
+void print_usage(char *name)
+{
+	fprintf(stderr,"\nUsage:\t%s [Options]\n", name);
+	fprintf(stderr,"\nOptions:");
+	fprintf(stderr,"\n\t-n\t<number> of trials per signal type and segmentation (default 1)");
+	fprintf(stderr,"\n\t-l\t<number> of samples per signal (default 4000)");
+	fprintf(stderr,"\n\t-s\t<value> of the random seed (default 1)");
+	fprintf(stderr,"\n");
+	exit(-1);
+}
+
+/*=====================================================================*/
+
+float next_uniform(void)
+{
+	rand_state = rand_state * 1103515245u + 12345u;
+	return (float)((double)(rand_state >> 8) / (double)(1u << 23) - 1.);
+}
+
+/* test signal of type 0: full scale, 1: low level, 2: sparse impulses,
+   3: tiny values, 4: clipped square wave                              */
+void make_signal(float *buf, long n, int type)
+{
+	long i;
+
+	for (i=0 ; i<n ; i++)
+	{
+		switch (type)
+		{
+		  case 0:
+			buf[i] = next_uniform();
+			break;
+		  case 1:
+			buf[i] = 1e-3f * next_uniform();
+			break;
+		  case 2:
+			buf[i] = (next_uniform() > 0.95f) ? next_uniform() : 0.f;
+			break;
+		  case 3:
+			buf[i] = 1e-35f * next_uniform();
+			break;
+		  default:
+			buf[i] = ( (i / (7 + (long)(rand_state % 50))) % 2) ? 1.f : -1.f;
+			next_uniform();
+			break;
+		}
+	}
+}
+
+/* length of the next segment of pattern 0: whole signal, 1: single
+   samples (then the rest), 2: odd fixed lengths, 3: random lengths
+   (including 0)                                                       */
+long next_segment(int pattern, long done, long n)
+{
+	static const long odd[] = { 3, 7, 13, 161, 1, 999 };
+	long len;
+
+	switch (pattern)
+	{
+	  case 0:
+		len = n;
+		break;
+	  case 1:
+		len = (done < SINGLE_SAMPLES) ? 1 : n - done;
+		break;
+	  case 2:
+		len = odd[(done / 7) % 6];
+		break;
+	  default:
+		len = (long)((next_uniform() + 1.f) * 0.5f * MAX_SEGMENT);
+		break;
+	}
+	return (len > n - done) ? n - done : len;
+}
+
+/* distance of two floats in units in the last place */
+long ulp_diff(float a, float b)
+{
+	int32_t ia, ib;
+
+	memcpy(&ia, &a, sizeof(ia));
+	memcpy(&ib, &b, sizeof(ib));
+	if (ia < 0)
+		ia = INT32_MIN - ia;
+	if (ib < 0)
+		ib = INT32_MIN - ib;
+	return labs((long)ia - (long)ib);
+}
+
+void compare(CHECK_RESULT *res, float *ref, float *opt, long n)
+{
+	long i, ulp;
+
+	for (i=0 ; i<n ; i++)
+	{
+		if (fabs((double)ref[i] - (double)opt[i]) > res->max_abs)
+			res->max_abs = fabs((double)ref[i] - (double)opt[i]);
+		if ( (ulp = ulp_diff(ref[i], opt[i])) > res->max_ulp)
+			res->max_ulp = ulp;
+	}
+	res->samples += n;
+}
+
+/* one line of the table, 1 if the kernel failed */
+int report(const char *name, int isa, CHECK_RESULT *res, int tol)
+{
+	int failed = (res->max_ulp > tol) || (res->mismatches > 0);
+
+	printf("%-24s %-7s %8ld %10ld %12.4g %8ld %6d  %s\n", name, fant_isa_names[isa], res->calls, res->samples,
+		res->max_abs, res->max_ulp, tol, failed ? "FAILED" : "ok");
+	return failed;
+}
+
+/***  one signal through hq_kernel() and a variant of fant_fir_kernel()  ***/
+int check_fir(const FIR_CASE *fc, FANT_FIR_FN fir, float *signal, long n, int pattern, CHECK_RESULT *res)
+{
+	SCD_FIR *ref, *opt;
+	float   *y_ref, *y_opt;
+	long     done, len, no_ref, no_opt, k;
+
+	ref = fc->init();
+	opt = fant_fir_init(fc->table);
+	y_ref = (float*)calloc((size_t)(n+1) * 3, sizeof(float));
+	y_opt = (float*)calloc((size_t)(n+1) * 3, sizeof(float));
+	if ( (ref == NULL) || (opt == NULL) || (y_ref == NULL) || (y_opt == NULL) )
+		return -1;
+	for (done=0 ; done<n ; done+=len)
+	{
+		len = next_segment(pattern, done, n);
+		no_ref = hq_kernel(len, signal+done, ref, y_ref);
+		no_opt = fir(len, signal+done, opt, y_opt);
+		res->calls++;
+		if (no_ref != no_opt)
+			res->mismatches++;
+		compare(res, y_ref, y_opt, (no_ref < no_opt) ? no_ref : no_opt);
+	}
+	/* the state for a following segment */
+	if (ref->k0 != opt->k0)
+		res->mismatches++;
+	for (k=0 ; k<ref->lenh0/((ref->hswitch == 'U') ? ref->dwn_up : 1)-1 ; k++)
+	{
+		if (memcmp(&ref->T[k], &opt->T[k], sizeof(float)) != 0)
+			res->mismatches++;
+	}
+	hq_free(ref);
+	fant_fir_free(opt);
+	free(y_ref);
+	free(y_opt);
+	return 0;
+}
+
+/***  all 16 bit values and random floats (also clipped) in both directions  ***/
+void check_conv(FANT_SH2FL_FN to_float, FANT_FL2SH_FN to_short, CHECK_RESULT *res)
+{
+	static short s_ref[65536], s_opt[65536];
+	static float y_ref[65536], y_opt[65536];
+	long         i, t;
+
+	for (i=0 ; i<65536 ; i++)
+		s_ref[i] = (short)(i - 32768);
+	sh2fl_16bit(65536, s_ref, y_ref, 1);
+	to_float(65536, s_ref, y_opt);
+	res->calls++;
+	compare(res, y_ref, y_opt, 65536);
+	for (t=0 ; t<16 ; t++)
+	{
+		for (i=0 ; i<65536 ; i++)
+			y_ref[i] = (t < 8) ? next_uniform() * (float)(t + 1) * 0.25f : y_opt[i] + (float)(t - 12) / 65536.f;
+		res->calls++;
+		if (fl2sh_16bit(65536, y_ref, s_ref, 1) != to_short(65536, y_ref, s_opt))
+			res->mismatches++;
+		for (i=0 ; i<65536 ; i++)
+		{
+			if (labs((long)s_ref[i] - (long)s_opt[i]) > res->max_ulp)
+				res->max_ulp = labs((long)s_ref[i] - (long)s_opt[i]);
+			if (fabs((double)s_ref[i] - (double)s_opt[i]) > res->max_abs)
+				res->max_abs = fabs((double)s_ref[i] - (double)s_opt[i]);
+		}
+		res->samples += 65536;
+	}
+}
@@ -0,0 +1,156 @@
+/*
+********************************************************************************
+*
+*      File             : fant_client.c
+*      Tested Platforms : Linux-OS
+*      Description      : Local test client for the server mode of
+*                         filter_add_noise (--serve). One request is sent,
+*                         the reply line is printed on stderr.
+*                         An input "-" sends the samples read from stdin
+*                         inline, an output "-" writes the returned samples
+*                         to stdout.
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+void print_usage(char*);
+short* load_short_samples(FILE *, long *);
+
+/*=====================================================================*/
+
+int  main(int argc, char *argv[])
+{
+	struct sockaddr_un addr;
+	FILE       *fp_in, *fp_out;
+	short      *buf = NULL;
+	long        no_samples = 0;
+	char       *line = NULL, *dum;
+	size_t      len = 0;
+	int         fd, i;
+
+	if (argc < 3)
+		print_usage(argv[0]);
+	if ( (fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+	{
+		perror("socket");
+		exit(-1);
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, argv[1], sizeof(addr.sun_path)-1);
+	if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+	{
+		fprintf(stderr, "\ncannot connect to socket %s\n", argv[1]);
+		exit(-1);
+	}
+	fp_in = fdopen(dup(fd), "r");
+	fp_out = fdopen(fd, "w");
+
+	if (strcmp(argv[2], "shutdown") == 0)
+	{
+		fprintf(fp_out, "SHUTDOWN\n");
+	}
+	else
+	{
+		if (argc < 4)
+			print_usage(argv[0]);
+		fprintf(fp_out, "MIX %s %s", argv[2], argv[3]);
+		for (i=4 ; i<argc ; i++)
+			fprintf(fp_out, " %s", argv[i]);
+		if (strcmp(argv[2], "-") == 0)
+		{
+			buf = load_short_samples(stdin, &no_samples);
+			fprintf(fp_out, " n=%ld\n", no_samples);
+			fwrite(buf, sizeof(short), (size_t)no_samples, fp_out);
+			free(buf);
+		}
+		else
+			fprintf(fp_out, "\n");
+	}
+	fflush(fp_out);
+
+	if (getline(&line, &len, fp_in) <= 0)
+	{
+		fprintf(stderr, "\nno reply from server\n");
+		exit(-1);
+	}
+	fprintf(stderr, "%s", line);
+	if (strncmp(line, "OK", 2) != 0)
+		exit(-1);
+	if ( (argc > 3) && (strcmp(argv[3], "-") == 0) &&
+	     ((dum = strstr(line, "samples=")) != NULL) && (sscanf(dum, "samples=%ld", &no_samples) == 1) )
+	{
+		if ( ( buf = (short*)calloc((size_t)no_samples+1, sizeof(short))) == NULL)
+		{
+			fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+			exit(-1);
+		}
+		if (fread(buf, sizeof(short), (size_t)no_samples, fp_in) != (size_t)no_samples)
+		{
+			fprintf(stderr, "\nincomplete samples from server\n");
+			exit(-1);
+		}
+		fwrite(buf, sizeof(short), (size_t)no_samples, stdout);
+		free(buf);
+	}
+	free(line);
+	fclose(fp_out);
+	fclose(fp_in);
+	return 0;
+}
+
+/*=====================================================================*/
+
+void print_usage(char *name)
+{
+	fprintf(stderr,"\nUsage:\t%s <socket> <input> <output> [snr=<dB>] [seed=<n>] [start=<n>] [noise=<id>]", name);
+	fprintf(stderr,"\n\t%s <socket> shutdown", name);
+	fprintf(stderr,"\n\n\t(\"-\" as input sends the samples from stdin,");
+	fprintf(stderr,"\n\t \"-\" as output writes the returned samples to stdout)");
+	fprintf(stderr,"\n");
+	exit(-1);
+}
+
+short *load_short_samples(FILE *fp, long *no_samples)
+{
+    short *buf;
+    size_t unit = 1048576, readed;
+    void *newPtr = NULL;
+    *no_samples=0;
+
+	if ( ( buf = (short*)calloc((size_t)unit, sizeof(short))) == NULL)
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+
+	while ( (readed = fread(buf+*no_samples, sizeof(short), (size_t)unit, fp)) != 0 )
+	{
+		*no_samples += readed;
+		unit += unit;
+
+		if ((newPtr = realloc(buf, (*no_samples + unit) * sizeof (short))) != NULL)
+		    buf = (short*) newPtr;
+		else
+		{
+			free(buf);
+			fprintf(stderr, "cannot reallocate enough memory to buffer samples!\n");
+			exit(-1);
+		}
+	}
+	return buf;
+}
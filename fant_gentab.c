@@ -0,0 +1,83 @@
+/*
+********************************************************************************
+*
+*      File             : fant_gentab.c
+*      Tested Platforms : Linux-OS
+*      Description      : Build step writing fant-tables.c (see fant-tables.h)
+*                         to stdout: every FIR filter of the ITU-T STL is
+*                         initialized as the library would do it and its
+*                         scaled coefficients are emitted as an aligned,
+*                         zero padded static const table in hexadecimal
+*                         float notation, followed by fant_fir_tables[].
+*
+*      Revision history
+*
+*      Rev  Date       Name            Description
+*      -------------------------------------------------------------------
+*      p1a  18-10-26                   basic version
+*
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "firflt.h"
+#include "fant-tables.h"
+
+typedef struct {
+	const char *name;
+	SCD_FIR  *(*init)(void);
+} GEN_CASE;
+
+/* in the order of the FANT_T_... ids */
+static const GEN_CASE gen_cases[FANT_NO_FIR_TABLES] = {
+	{ "hq_down_2_to_1",         hq_down_2_to_1_init },
+	{ "hq_up_1_to_2",           hq_up_1_to_2_init },
+	{ "hq_down_3_to_1",         hq_down_3_to_1_init },
+	{ "hq_up_1_to_3",           hq_up_1_to_3_init },
+	{ "linear_phase_pb_2_to_1", linear_phase_pb_2_to_1_init },
+	{ "linear_phase_pb_1_to_2", linear_phase_pb_1_to_2_init },
+	{ "fir_hp_8khz",            fir_hp_8khz_init },
+	{ "irs_8khz",               irs_8khz_init },
+	{ "irs_16khz",              irs_16khz_init },
+	{ "mod_irs_16khz",          mod_irs_16khz_init },
+	{ "mod_irs_48khz",          mod_irs_48khz_init },
+	{ "p341_16khz",             p341_16khz_init } };
+
+/*=====================================================================*/
+
+int  main(int argc, char *argv[])
+{
+	SCD_FIR *fir[FANT_NO_FIR_TABLES];
+	long     k, len;
+	int      i;
+
+	printf("/* fant-tables.c: generated by fant_gentab, do not edit (see fant-tables.h) */\n\n");
+	printf("#include \"fant-tables.h\"\n");
+	for (i=0 ; i<FANT_NO_FIR_TABLES ; i++)
+	{
+		if ( (fir[i] = gen_cases[i].init()) == NULL)
+		{
+			fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+			exit(-1);
+		}
+		len = (fir[i]->lenh0 + FANT_TABLE_PAD - 1) / FANT_TABLE_PAD * FANT_TABLE_PAD;
+		printf("\nstatic const float h0_%s[%ld] __attribute__((aligned(%d))) = {", gen_cases[i].name, len,
+			FANT_TABLE_ALIGN);
+		for (k=0 ; k<len ; k++)
+			printf("%s%s%af", (k > 0) ? "," : "", (k % 4 == 0) ? "\n\t" : " ",
+				(k < fir[i]->lenh0) ? (double)fir[i]->h0[k] : 0.);
+		printf(" };\n");
+	}
+
+	printf("\nconst FANT_FIR_TABLE fant_fir_tables[FANT_NO_FIR_TABLES] = {");
+	for (i=0 ; i<FANT_NO_FIR_TABLES ; i++)
+	{
+		printf("%s\n\t{ \"%s\", %ld, %ld, '%c', h0_%s }", (i > 0) ? "," : "", gen_cases[i].name,
+			fir[i]->lenh0, fir[i]->dwn_up, fir[i]->hswitch, gen_cases[i].name);
+		hq_free(fir[i]);
+	}
+	printf(" };\n");
+	return 0;
+}
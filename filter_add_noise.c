@@ -16,7 +16,8 @@
 *                         Filtering and level estimation are done with the
 *                         ITU tools.
 *                         Speech and noise data can be processed that have been
-*                         sampled a 8 kHz or at 16 kHz.
+*                         sampled a 8 kHz or at 16 kHz (and at 32 or 48 kHz,
+*                         measured after downsampling to 16 kHz).
 *                         The levels of speech and noise (S and N) can be calculated
 *                         after applying different filtering methods.
 *                         For 16 kHz data:
@@ -57,6 +58,11 @@
 *                                      data with a P.341 characteristic
 *      p6a  09-06-10   G. Hirsch       overflow check also in case of level normalization 
 *                                      only (suggested by D. Gelbart and J.I. Biel)
+*      p7a  18-10-26                   filtering, level estimation and noise adding
+*                                      moved to the reentrant library fant-lib.c
+*      p7b  18-10-26                   32 and 48 kHz data (--rate)
+*      p7c  18-10-26                   noise files at another sample rate
+*                                      resampled on loading (--noise-rate)
 *
 ********************************************************************************
 */
@@ -75,32 +81,59 @@ const char module_id[] = "@(#)$Id: $";
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
+#include <getopt.h>
 
 #include "ugst-utl.h"
-#include "iirflt.h"
-#include "firflt.h"
-#include "sv-p56.h"
-
-#define NONE   9999
-#define FILTER 0x1
-#define NORM   0x2
-#define ADD    0x4
-#define SAMP16K    0x8
-#define SNRANGE    0x10
-#define SNR_4khz   0x20
-#define SNR_8khz   0x40
-#define DC_COMP    0x80
-#define IND_LIST   0x100
-#define A_WEIGHT   0x200
-
-#define P341_FILTER_SHIFT  125
-#define IRS_FILTER_SHIFT    75
-#define MIRS_FILTER_SHIFT  182
-#define P341_16K_FILTER_SHIFT  296
+#include "fant.h"
+#include "fant-serve.h"
+#include "fant-stream.h"
+#include "fant-io.h"
+#include "fant-arc.h"
+#include "fant-manifest.h"
+#include "fant-cache.h"
+#include "fant-journal.h"
+#include "fant-stats.h"
+#include "fant-trace.h"
+#include "fant-perf.h"
+#include "fant-results.h"
+#include "fant-kern.h"
+#include "fant-feat.h"
+#include "fant-wav.h"
 
-/*=====================================================================*/
+/* options without short form */
+#define OPT_SERVE  1000
+#define OPT_STREAM 1001
+#define OPT_PREFETCH   1002
+#define OPT_IO_THREADS 1003
+#define OPT_ARCHIVE    1004
+#define OPT_SHARD      1005
+#define OPT_MANIFEST   1006
+#define OPT_CACHE      1007
+#define OPT_CACHE_FILTERED 1008
+#define OPT_JOURNAL    1009
+#define OPT_RESUME     1010
+#define OPT_FAILURES   1011
+#define OPT_STATS      1012
+#define OPT_TRACE      1013
+#define OPT_PERF       1014
+#define OPT_RESULTS    1015
+#define OPT_KERNELS    1016
+#define OPT_EXPLAIN    1017
+#define OPT_CLEAN      1018
+#define OPT_SCALED_NOISE 1019
+#define OPT_FEATURES   1020
+#define OPT_FEATURES_ONLY 1021
+#define OPT_FEAT_PARAMS 1022
+#define OPT_BIG_ENDIAN 1023
+#define OPT_FORMAT     1024
+#define OPT_RATE       1025
+#define OPT_NOISE_RATE 1026
+
+#define WIDEBAND       (SAMP16K | SAMP32K | SAMP48K)
 
-enum { G712, P341, IRS, MIRS, G712_16K, P341_16K, DOWN };
+#define TRACE_SPANS    65536  /* per thread */
+
+/*=====================================================================*/
 
 typedef struct	{
 		char  *input_list;
@@ -114,6 +147,36 @@ typedef struct	{
 		int    seed;
         	char  *log_file;
         	int    mode;
+		char  *serve;
+		int    stream;
+		int    prefetch;     /* speech files read ahead, 0: synchronous I/O */
+		int    io_threads;
+		char  *archive;      /* outputs appended to this archive */
+		long   shard_size;   /* records per archive file, 0: one archive */
+		char  *manifest;     /* jobs with conditions per utterance */
+		char  *cache;        /* speech levels of earlier runs */
+		int    cache_filtered; /* also cache the filtered speech */
+		char  *journal;      /* completed entries */
+		int    resume;       /* skip the journaled entries */
+		char  *failures;     /* report of failed entries, else exit */
+		char  *stats_file;   /* timing statistics (JSON) */
+		FANT_STATS *stats;   /* collected if stats_file is given */
+		char  *trace;        /* timeline of the run (Chrome trace) */
+		char  *perf;         /* hardware counters per kernel (JSON) */
+		char  *results_file; /* record per file (JSONL or CSV) */
+		char  *kernels;      /* reference, auto or instruction set */
+		int    explain;      /* print the processing plan and stop */
+		char  *clean;        /* name template (%s: output) of the clean speech */
+		char  *scaled_noise; /* name template of the scaled noise */
+		char  *features;     /* name template of the log-mel features */
+		int    features_only; /* no waveform outputs */
+		double feat_win;     /* frame length (ms) */
+		double feat_hop;     /* frame shift (ms) */
+		int    feat_bins;    /* mel filters */
+		int    big_endian;   /* raw inputs are big endian */
+		int    float32;      /* float outputs, no overload correction */
+		int    noise_rate;   /* of raw noise files, 0: of the speech */
+		FANT_RESULTS *results;
 		} PARAMETER;
 
 
@@ -121,27 +184,103 @@ typedef struct	{
 void anal_comline(PARAMETER*, int, char**);
 void print_usage(char*);
 void write_logfile(PARAMETER*, FILE*);
-float* load_samples(FILE*, long *);
-short* load_short_samples(FILE *, long *);
-void filter_samples(float*, long, int);
-void write_samples(float*, long, char*);
-void DCOffsetFil(float*, long, int);
-void AWeightFil(float*, long, int);
+float* load_samples(FILE*, long *, int, int*, int, const char*);
+void write_samples(float*, long, char*, int, int);
 void process_one_file(PARAMETER,char *,char *,
-     long,float *,float *,
-	FILE *,FILE *);
+	FANT_CONTEXT *,FILE *,FILE *);
+void process_stream(PARAMETER*, FANT_CONTEXT*, FILE*, FILE*);
+long process_list(PARAMETER*, FILE*, FILE*, FANT_MANIFEST*, FANT_CONTEXT*, FILE*, FILE*);
+long track_outputs(PARAMETER*, FANT_IO*, FANT_JOURNAL*, FILE*);
+void report_failure(FILE*, FANT_JOB*, const char*);
+FANT_ARC *open_archive(PARAMETER*, int, char*);
+FANT_MANIFEST *read_manifest(PARAMETER*);
+void load_noises(PARAMETER*, FANT_MANIFEST*, FANT_CONTEXT*, FILE*);
+int  load_noise(FANT_CONTEXT*, char*, int, int, FILE*);
+int  compare_noises(const void*, const void*);
+int  draw_request(PARAMETER*, FANT_CONTEXT*, long, FILE*, FANT_REQUEST*);
+void write_result(PARAMETER*, FILE*, char*, FANT_REQUEST*, FANT_RESULT*);
+void write_triplet(PARAMETER*, FANT_IO*, const char*, short*, long, FANT_REQUEST*, long, FILE*);
+void write_features(PARAMETER*, FANT_FEAT*, const char*, short*, long);
+char *template_name(const char*, const char*);
+int  valid_template(const char*);
+void add_result(PARAMETER*, long, const char*, const char*, long, FANT_REQUEST*,
+	FANT_RESULT*, const char*, double);
+int  process_cached(PARAMETER*, FANT_CONTEXT*, FANT_CACHE*, char*, short*, long,
+	FANT_REQUEST*, FANT_RESULT*, float**);
+int  process_float(FANT_CONTEXT*, short*, long, FANT_REQUEST*, FANT_RESULT*, float**);
+int  sample_rate(int);
 
 /*=====================================================================*/
 
 int  main(int argc, char *argv[])
 {
 	PARAMETER	pars;
-	FILE       *fp_log, *fp_noise=NULL, *fp_list, *fp_outlist, *fp_index=NULL;
-	long        no_noise_samples=0, i;
-	float      *noise=NULL, *noise_g712=NULL;
+	FILE       *fp_log, *fp_list, *fp_outlist, *fp_index=NULL;
+	long        i;
 	char        filename[300], out_filename[300];
+	FANT_CONTEXT *ctx;
+	FANT_PARAMS fant_pars;
+	FANT_MANIFEST *man = NULL;
+	int         filters = 0, type;
+	long        no_failed = 0;
 	
 	anal_comline(&pars, argc, argv);
+	if (pars.trace != NULL)
+	{
+		fant_trace_start(TRACE_SPANS);
+		fant_trace_thread("main");
+	}
+	if (pars.perf != NULL)
+		fant_perf_start();
+	if (fant_kernels_select(pars.kernels) != FANT_OK)
+	{
+		fprintf(stderr, "\nunknown or unsupported kernels %s (reference, auto, scalar, avx2 or avx512)\n\n", pars.kernels);
+		exit(-1);
+	}
+	if ( (pars.stats_file != NULL) && ( (pars.stats = fant_stats_init()) == NULL) )
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+	if ( (pars.results_file != NULL) && ( (pars.results = fant_results_open(pars.results_file)) == NULL) )
+	{
+		fprintf(stderr, "\ncannot open results file %s\n\n", pars.results_file);
+		exit(-1);
+	}
+	if (pars.manifest != NULL)
+	{
+		man = read_manifest(&pars);
+		for (i=0 ; i<man->no_jobs ; i++)
+		{
+			if (man->jobs[i].filter_type != NONE)
+				filters |= (1 << man->jobs[i].filter_type);
+		}
+	}
+	fant_pars.mode = pars.mode | (pars.float32 ? FLOAT_OUT : 0);
+	fant_pars.filter_type = pars.filter_type;
+	fant_pars.norm_level = pars.norm_level;
+	fant_pars.snr = pars.snr;
+	fant_pars.snr_range = pars.snr_range;
+	if ( (ctx = fant_init(&fant_pars, (pars.seed == -1) ? (unsigned int) time(NULL) : (unsigned int) pars.seed)) == NULL)
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+	if (pars.explain)
+	{
+		fant_plan_print(&ctx->plan, stdout);
+		fprintf(stdout, "  kernels:          %s (%s)\n", pars.kernels, fant_kernels.report);
+		fant_free(ctx);
+		exit(0);
+	}
+	for (type=0 ; type<FANT_NO_FILTERS ; type++)
+	{
+		if ( (filters & (1 << type)) && (fant_add_filter(ctx, type) != FANT_OK) )
+		{
+			fprintf(stderr, "\ncannot prepare the filters of manifest %s\n\n", pars.manifest);
+			exit(-1);
+		}
+	}
 	if ( (fp_log = fopen(pars.log_file, "a")) == NULL)
 	{
 		fprintf(stderr, "\ncannot open log file %s\n\n", pars.log_file);
@@ -158,65 +297,7 @@ int  main(int argc, char *argv[])
 				exit(-1);
 			}
 		}
-		if ( (fp_noise = fopen(pars.noise_file, "r")) == NULL)
-		{
-			fprintf(stderr, "\ncannot open noise file %s\n\n", pars.noise_file);
-			exit(-1);
-		}
-		/* load samples of noise signal twice
-		   Buffer "noise_g712" only used for calculating noise level N  */
-		noise = load_samples(fp_noise, &no_noise_samples);
-		if ( ( noise_g712 = (float*)calloc((size_t)no_noise_samples, sizeof(float))) == NULL)
-		{
-			fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
-			exit(-1);
-		}
-		memcpy(noise_g712,noise,sizeof(float)*no_noise_samples);
-		
-		fprintf(fp_log, " %ld noise samples loaded from %s\n", no_noise_samples, pars.noise_file);
-		fclose(fp_noise);
-
-		/* filter noise signal in buffer "noise_g712" */
-		if (pars.mode & SAMP16K)  /*  16 kHz data  */
-		{
-		    if (pars.mode & SNR_4khz)  /*  full 4 kHz bandwidth for calculating noise level N  */
-		    {
-			filter_samples(noise_g712, no_noise_samples, DOWN);  /*  downsampling  16 --> 8 kHz  */
-			if (pars.mode & DC_COMP)
-				DCOffsetFil(noise_g712, no_noise_samples/2, 8000);
-		    }
-		    else if (pars.mode & A_WEIGHT)
-		    {
-		        AWeightFil(noise_g712, no_noise_samples, 16000);
-		    }
-		    else if (pars.mode & SNR_8khz)
-		    {
-			if (pars.mode & DC_COMP)
-				DCOffsetFil(noise_g712, no_noise_samples, 16000);
-		    }
-		    else
-		    {
-			filter_samples(noise_g712, no_noise_samples, G712_16K);  /*  G.712 filtering of 16 K data  */
-			if (pars.mode & DC_COMP)
-				DCOffsetFil(noise_g712, no_noise_samples/2, 8000);
-		    }
-		}
-		else  /*  8 Khz data  */
-		{
-		    if (pars.mode & A_WEIGHT)  /* filtering with A-weighting curve */
-			AWeightFil(noise_g712, no_noise_samples, 8000);
-		    else if (!(pars.mode & SNR_4khz))  /* If NOT full 4 kHz bandwidth --> G.712 filtering  */
-			filter_samples(noise_g712, no_noise_samples, G712);
-		    if ( (pars.mode & DC_COMP) && (!(pars.mode & A_WEIGHT)) )
-		    	DCOffsetFil(noise_g712, no_noise_samples, 8000);
-		 }
-
-		/* filter noise signal in buffer "noise" */
-		if (pars.mode & FILTER)
-		{
-			filter_samples(noise, no_noise_samples, pars.filter_type);
-			fprintf(fp_log, " Noise signal filtered\n");
-		}
+		load_noises(&pars, man, ctx, fp_log);
 		if (pars.seed == -1)
 		{
 			srand((unsigned int) time(NULL));
@@ -231,13 +312,26 @@ int  main(int argc, char *argv[])
 	fprintf(fp_log," ---------------------------------------------------------------------------\n");
 	fprintf(fp_log, "Processing started ...\n");
 
-	if ( pars.input_list == NULL)
+	if ( pars.serve != NULL)
+	{
+		if (fant_serve(ctx, pars.serve, pars.big_endian, fp_log) != FANT_OK)
+			exit(-1);
+	}
+	else if ( pars.stream)
+	{
+		process_stream(&pars, ctx, fp_index, fp_log);
+	}
+	else if ( man != NULL)
+	{
+		no_failed = process_list(&pars, NULL, NULL, man, ctx, fp_index, fp_log);
+		fant_free_manifest(man);
+	}
+	else if ( pars.input_list == NULL)
 	{
 		if ( pars.output_list == NULL)
 		{
 			process_one_file(pars,NULL,NULL,
-	              no_noise_samples,noise,noise_g712,
-				fp_index,fp_log);
+				ctx,fp_index,fp_log);
 		}
 		else if ( (fp_outlist = fopen(pars.output_list, "r")) == NULL)
 		{
@@ -252,8 +346,7 @@ int  main(int argc, char *argv[])
 				exit(-1);
 			}
 			process_one_file(pars,NULL,out_filename,
-	              no_noise_samples,noise,noise_g712,
-				fp_index,fp_log);
+				ctx,fp_index,fp_log);
 			fclose(fp_outlist);
 		}
 	}
@@ -264,7 +357,21 @@ int  main(int argc, char *argv[])
 	}
 	else
 	{
-		if ( pars.output_list == NULL)
+		if ( pars.archive != NULL)
+		{
+			/* names of the records from output list or input list */
+			if ( pars.output_list == NULL)
+				fp_outlist = NULL;
+			else if ( (fp_outlist = fopen(pars.output_list, "r")) == NULL)
+			{
+				fprintf(stderr, "\ncannot open list file %s\n", pars.output_list);
+				exit(-1);
+			}
+			no_failed = process_list(&pars, fp_list, fp_outlist, NULL, ctx, fp_index, fp_log);
+			if ( fp_outlist != NULL)
+				fclose(fp_outlist);
+		}
+		else if ( pars.output_list == NULL)
 		{
 			for (i=0 ; fscanf(fp_list, "%s", filename) != EOF ; i++)
 			{
@@ -274,8 +381,7 @@ int  main(int argc, char *argv[])
 					exit(-1);
 				}
 				process_one_file(pars,filename,NULL,
-		              no_noise_samples,noise,noise_g712,
-					fp_index,fp_log);
+					ctx,fp_index,fp_log);
 			}
 		}
 		else if ( (fp_outlist = fopen(pars.output_list, "r")) == NULL)
@@ -283,6 +389,11 @@ int  main(int argc, char *argv[])
 			fprintf(stderr, "\ncannot open list file %s\n", pars.output_list);
 			exit(-1);
 		}
+		else if ( (pars.prefetch > 0) || (pars.cache != NULL) || (pars.journal != NULL) || (pars.failures != NULL) )
+		{
+			no_failed = process_list(&pars, fp_list, fp_outlist, NULL, ctx, fp_index, fp_log);
+			fclose(fp_outlist);
+		}
 		else
 		{
 			while ( fscanf(fp_list, "%s", filename) != EOF)
@@ -293,8 +404,7 @@ int  main(int argc, char *argv[])
 					exit(-1);
 				}
 				process_one_file(pars,filename,out_filename,
-		              no_noise_samples,noise,noise_g712,
-					fp_index,fp_log);
+					ctx,fp_index,fp_log);
 			}
 			fclose(fp_outlist);
 		}
@@ -303,12 +413,37 @@ int  main(int argc, char *argv[])
 	
 	fprintf(fp_log," --------------------------------------------------------------------------\n\n");
 	fclose(fp_log);
-	if (pars.mode & ADD)
+	fant_free(ctx);
+	if (fp_index != NULL)  /* only opened for noise adding */
+		fclose(fp_index);
+	if ( (pars.trace != NULL) && (fant_trace_write(pars.trace) != FANT_OK) )
 	{
-		free(noise_g712);
-		free(noise);
-		if (pars.mode & IND_LIST)
-			fclose(fp_index);
+		fprintf(stderr, "\ncannot write trace file %s\n\n", pars.trace);
+		exit(-1);
+	}
+	if ( (pars.perf != NULL) && (fant_perf_write(pars.perf) != FANT_OK) )
+	{
+		fprintf(stderr, "\ncannot write counter file %s\n\n", pars.perf);
+		exit(-1);
+	}
+	if (pars.stats != NULL)
+	{
+		if (fant_stats_write(pars.stats, pars.stats_file, (double)sample_rate(pars.mode)) != FANT_OK)
+		{
+			fprintf(stderr, "\ncannot write statistics file %s\n\n", pars.stats_file);
+			exit(-1);
+		}
+		fant_stats_free(pars.stats);
+	}
+	if ( (pars.results != NULL) && (fant_results_close(pars.results) != FANT_OK) )
+	{
+		fprintf(stderr, "\ncannot write results file %s\n\n", pars.results_file);
+		exit(-1);
+	}
+	if (no_failed > 0)
+	{
+		fprintf(stderr, "\n%ld files could not be processed, see %s\n", no_failed, pars.failures);
+		exit(-1);
 	}
 	return 0;
 }
@@ -321,6 +456,36 @@ void	anal_comline(PARAMETER *pars, int argc, char** argv)
 	int c;
 	extern	int optind;
 	extern	char *optarg;
+	static struct option long_options[] = {
+		{ "serve", required_argument, NULL, OPT_SERVE },
+		{ "stream", no_argument, NULL, OPT_STREAM },
+		{ "prefetch", required_argument, NULL, OPT_PREFETCH },
+		{ "io-threads", required_argument, NULL, OPT_IO_THREADS },
+		{ "archive", required_argument, NULL, OPT_ARCHIVE },
+		{ "shard", required_argument, NULL, OPT_SHARD },
+		{ "manifest", required_argument, NULL, OPT_MANIFEST },
+		{ "cache", required_argument, NULL, OPT_CACHE },
+		{ "cache-filtered", no_argument, NULL, OPT_CACHE_FILTERED },
+		{ "journal", required_argument, NULL, OPT_JOURNAL },
+		{ "resume", no_argument, NULL, OPT_RESUME },
+		{ "failures", required_argument, NULL, OPT_FAILURES },
+		{ "stats", required_argument, NULL, OPT_STATS },
+		{ "trace", required_argument, NULL, OPT_TRACE },
+		{ "perf", required_argument, NULL, OPT_PERF },
+		{ "results", required_argument, NULL, OPT_RESULTS },
+		{ "kernels", required_argument, NULL, OPT_KERNELS },
+		{ "explain", no_argument, NULL, OPT_EXPLAIN },
+		{ "clean", required_argument, NULL, OPT_CLEAN },
+		{ "scaled-noise", required_argument, NULL, OPT_SCALED_NOISE },
+		{ "features", required_argument, NULL, OPT_FEATURES },
+		{ "features-only", no_argument, NULL, OPT_FEATURES_ONLY },
+		{ "feat-params", required_argument, NULL, OPT_FEAT_PARAMS },
+		{ "big-endian", no_argument, NULL, OPT_BIG_ENDIAN },
+		{ "format", required_argument, NULL, OPT_FORMAT },
+		{ "rate", required_argument, NULL, OPT_RATE },
+		{ "noise-rate", required_argument, NULL, OPT_NOISE_RATE },
+		{ NULL, 0, NULL, 0 }
+	};
 
 	pars->mode = 0;
 	pars->input_list = NULL;
@@ -332,13 +497,43 @@ void	anal_comline(PARAMETER *pars, int argc, char** argv)
 	pars->filter_type = NONE;
 	pars->log_file = NULL;
 	pars->seed = -1;
+	pars->serve = NULL;
+	pars->stream = 0;
+	pars->prefetch = 4;
+	pars->io_threads = 2;
+	pars->archive = NULL;
+	pars->shard_size = 0;
+	pars->manifest = NULL;
+	pars->cache = NULL;
+	pars->cache_filtered = 0;
+	pars->journal = NULL;
+	pars->resume = 0;
+	pars->failures = NULL;
+	pars->stats_file = NULL;
+	pars->stats = NULL;
+	pars->trace = NULL;
+	pars->perf = NULL;
+	pars->results_file = NULL;
+	pars->kernels = NULL;
+	pars->explain = 0;
+	pars->clean = NULL;
+	pars->scaled_noise = NULL;
+	pars->features = NULL;
+	pars->features_only = 0;
+	pars->feat_win = 25.;
+	pars->feat_hop = 10.;
+	pars->feat_bins = 40;
+	pars->big_endian = 0;
+	pars->float32 = 0;
+	pars->noise_rate = 0;
+	pars->results = NULL;
 
 	if (argc == 1) /* no arguments */
 	{
 		print_usage(argv[0]);
 	}
 
-	while( (c = getopt(argc, argv, "udhi:o:n:f:m:l:s:r:w:e:a:")) != -1)
+	while( (c = getopt_long(argc, argv, "udhi:o:n:f:m:l:s:r:w:e:a:", long_options, NULL)) != -1)
 	{
 	  /*  printf("Optind: %d Optarg: %s   c: %c\n", optind, optarg, c);  */
 	  switch(c)
@@ -404,7 +599,7 @@ void	anal_comline(PARAMETER *pars, int argc, char** argv)
 			pars->seed = atoi(optarg);
 			break;
 		case 'u':
-			pars->mode = pars->mode | SAMP16K;
+			pars->mode = (pars->mode & ~WIDEBAND) | SAMP16K;
 			break;
 		case 'd':
 			pars->mode = pars->mode | DC_COMP;
@@ -425,6 +620,119 @@ void	anal_comline(PARAMETER *pars, int argc, char** argv)
 		case 'e':
 			pars->log_file = optarg;
 			break;
+		case OPT_SERVE:
+			pars->serve = optarg;
+			break;
+		case OPT_STREAM:
+			pars->stream = 1;
+			break;
+		case OPT_PREFETCH:
+			pars->prefetch = atoi(optarg);
+			break;
+		case OPT_IO_THREADS:
+			pars->io_threads = atoi(optarg);
+			break;
+		case OPT_ARCHIVE:
+			pars->archive = optarg;
+			break;
+		case OPT_SHARD:
+			pars->shard_size = atol(optarg);
+			break;
+		case OPT_MANIFEST:
+			pars->manifest = optarg;
+			if (access(pars->manifest, F_OK) == -1)
+			{
+				fprintf(stderr, "\nunable to access manifest %s\n", pars->manifest);
+				print_usage(argv[0]);
+			}
+			break;
+		case OPT_CACHE:
+			pars->cache = optarg;
+			break;
+		case OPT_CACHE_FILTERED:
+			pars->cache_filtered = 1;
+			break;
+		case OPT_JOURNAL:
+			pars->journal = optarg;
+			break;
+		case OPT_RESUME:
+			pars->resume = 1;
+			break;
+		case OPT_FAILURES:
+			pars->failures = optarg;
+			break;
+		case OPT_STATS:
+			pars->stats_file = optarg;
+			break;
+		case OPT_TRACE:
+			pars->trace = optarg;
+			break;
+		case OPT_PERF:
+			pars->perf = optarg;
+			break;
+		case OPT_RESULTS:
+			pars->results_file = optarg;
+			break;
+		case OPT_KERNELS:
+			pars->kernels = optarg;
+			break;
+		case OPT_EXPLAIN:
+			pars->explain = 1;
+			break;
+		case OPT_CLEAN:
+			pars->clean = optarg;
+			break;
+		case OPT_SCALED_NOISE:
+			pars->scaled_noise = optarg;
+			break;
+		case OPT_FEATURES:
+			pars->features = optarg;
+			break;
+		case OPT_FEATURES_ONLY:
+			pars->features_only = 1;
+			break;
+		case OPT_BIG_ENDIAN:
+			pars->big_endian = 1;
+			break;
+		case OPT_FORMAT:
+			if (strcmp(optarg, "float32") == 0)
+				pars->float32 = 1;
+			else if (strcmp(optarg, "int16") == 0)
+				pars->float32 = 0;
+			else
+			{
+				fprintf(stderr,"\ninvalid output format %s (int16 or float32) ...\n", optarg);
+				print_usage(argv[0]);
+			}
+			break;
+		case OPT_RATE:
+			pars->mode = pars->mode & ~WIDEBAND;
+			if (atoi(optarg) == 16000)
+				pars->mode = pars->mode | SAMP16K;
+			else if (atoi(optarg) == 32000)
+				pars->mode = pars->mode | SAMP32K;
+			else if (atoi(optarg) == 48000)
+				pars->mode = pars->mode | SAMP48K;
+			else if (atoi(optarg) != 8000)
+			{
+				fprintf(stderr,"\ninvalid sampling rate %s (8000, 16000, 32000 or 48000) ...\n", optarg);
+				print_usage(argv[0]);
+			}
+			break;
+		case OPT_NOISE_RATE:
+			if ( (pars->noise_rate = atoi(optarg)) <= 0)
+			{
+				fprintf(stderr,"\ninvalid noise sampling rate %s ...\n", optarg);
+				print_usage(argv[0]);
+			}
+			break;
+		case OPT_FEAT_PARAMS:
+			if (sscanf(optarg, "%lf,%lf,%d", &pars->feat_win, &pars->feat_hop, &pars->feat_bins) != 3)
+			{
+				fprintf(stderr,"\ninvalid feature parameters %s (<win ms>,<hop ms>,<bins>) ...\n", optarg);
+				print_usage(argv[0]);
+			}
+			break;
 		case 'h':
 			print_usage(argv[0]);
 		default:
@@ -442,12 +750,12 @@ void	anal_comline(PARAMETER *pars, int argc, char** argv)
 	// 	fprintf(stderr, "\n\n Output list is not defined.");
 	// 	print_usage(argv[0]);
 	// }
-	if ( (pars->mode & ADD) && (pars->snr == NONE) )
+	if ( (pars->mode & ADD) && (pars->snr == NONE) && (pars->manifest == NULL) )
 	{
 		fprintf(stderr, "\n\n SNR not defined for noise adding.");
 		print_usage(argv[0]);
 	}
-	if ((pars->mode == 0) || (pars->mode == SNR_4khz) || (pars->mode == SNR_8khz) || (pars->mode == A_WEIGHT))
+	if ( ((pars->mode == 0) || (pars->mode == SNR_4khz) || (pars->mode == SNR_8khz) || (pars->mode == A_WEIGHT)) && (pars->manifest == NULL) )
 	{
 		fprintf(stderr, "\n\n Either noise adding nor filtering nor normalization defined!");
 		print_usage(argv[0]);
@@ -457,19 +765,123 @@ void	anal_comline(PARAMETER *pars, int argc, char** argv)
 		fprintf(stderr, "\n\n Processing of 16 kHz data can not be combined with G.712, IRS or MIRS filtering right now!");
 		print_usage(argv[0]);
 	}
-	if (!(pars->mode & SAMP16K) && (pars->mode & SNR_8khz))
+	if ((pars->mode & SAMP32K) && (pars->mode & FILTER))
+	{
+		fprintf(stderr, "\n\n Processing of 32 kHz data can not be combined with filtering right now!");
+		print_usage(argv[0]);
+	}
+	if ((pars->mode & SAMP48K) && (pars->mode & FILTER) && (pars->filter_type != MIRS))
+	{
+		fprintf(stderr, "\n\n Processing of 48 kHz data can only be combined with MIRS filtering right now!");
+		print_usage(argv[0]);
+	}
+	if (!(pars->mode & WIDEBAND) && (pars->mode & SNR_8khz))
 	{
 		fprintf(stderr, "\n\n S and N can be estimated from the 8 kHz range only in case of processing 16 kHz data!");
 		print_usage(argv[0]);
 	}
+	if ((pars->serve != NULL) && ((pars->input_list != NULL) || (pars->output_list != NULL) || (pars->mode & IND_LIST)))
+	{
+		fprintf(stderr, "\n\n The server mode can not be combined with list files!");
+		print_usage(argv[0]);
+	}
+	if (pars->stream && ((pars->input_list != NULL) || (pars->output_list != NULL) || (pars->serve != NULL)))
+	{
+		fprintf(stderr, "\n\n The stream mode can not be combined with list files or the server mode!");
+		print_usage(argv[0]);
+	}
+	if ((pars->manifest != NULL) && ((pars->input_list != NULL) || (pars->output_list != NULL) || (pars->serve != NULL) || pars->stream))
+	{
+		fprintf(stderr, "\n\n A manifest can not be combined with list files, the server or the stream mode!");
+		print_usage(argv[0]);
+	}
+	if ((pars->archive != NULL) && (pars->input_list == NULL) && (pars->manifest == NULL))
+	{
+		fprintf(stderr, "\n\n An output archive needs an input list or a manifest!");
+		print_usage(argv[0]);
+	}
+	if ((pars->shard_size < 0) || ((pars->shard_size > 0) && (pars->archive == NULL)))
+	{
+		fprintf(stderr, "\n\n Invalid number of records per archive file!");
+		print_usage(argv[0]);
+	}
+	if ((pars->cache != NULL) && (pars->input_list == NULL) && (pars->manifest == NULL))
+	{
+		fprintf(stderr, "\n\n The analysis cache needs an input list or a manifest!");
+		print_usage(argv[0]);
+	}
+	if (pars->cache_filtered && (pars->cache == NULL))
+	{
+		fprintf(stderr, "\n\n --cache-filtered needs a cache file (--cache)!");
+		print_usage(argv[0]);
+	}
+	if (((pars->journal != NULL) || (pars->failures != NULL)) && (pars->manifest == NULL) &&
+	    ((pars->input_list == NULL) || ((pars->output_list == NULL) && (pars->archive == NULL))))
+	{
+		fprintf(stderr, "\n\n A journal or a failure report needs input and output list or a manifest!");
+		print_usage(argv[0]);
+	}
+	if ((pars->journal != NULL) && (pars->archive != NULL))
+	{
+		fprintf(stderr, "\n\n A journal can not be combined with an output archive!");
+		print_usage(argv[0]);
+	}
+	if (pars->resume && (pars->journal == NULL))
+	{
+		fprintf(stderr, "\n\n --resume needs a journal (--journal)!");
+		print_usage(argv[0]);
+	}
+	if (((pars->clean != NULL) && !valid_template(pars->clean)) ||
+	    ((pars->scaled_noise != NULL) && !valid_template(pars->scaled_noise)))
+	{
+		fprintf(stderr, "\n\n The names of the clean speech and the scaled noise need one %%s for the output name!");
+		print_usage(argv[0]);
+	}
+	if (((pars->clean != NULL) || (pars->scaled_noise != NULL)) &&
+	    (((pars->input_list == NULL) && (pars->manifest == NULL)) || (pars->archive != NULL)))
+	{
+		fprintf(stderr, "\n\n Clean speech and scaled noise need an input list or a manifest and no output archive!");
+		print_usage(argv[0]);
+	}
+	if ((pars->features != NULL) &&
+	    (!valid_template(pars->features) || ((pars->input_list == NULL) && (pars->manifest == NULL))))
+	{
+		fprintf(stderr, "\n\n Features need an input list or a manifest and one %%s for the output name!");
+		print_usage(argv[0]);
+	}
+	if (pars->features_only && ((pars->features == NULL) || (pars->archive != NULL) || (pars->journal != NULL) || (pars->failures != NULL)))
+	{
+		fprintf(stderr, "\n\n --features-only needs --features and no archive, journal or failure report!");
+		print_usage(argv[0]);
+	}
+	if (pars->float32 && ((pars->serve != NULL) || pars->stream || (pars->archive != NULL) ||
+	    (pars->clean != NULL) || (pars->scaled_noise != NULL) || (pars->features != NULL)))
+	{
+		fprintf(stderr, "\n\n float32 outputs are written as files only, not with server, stream, archive,");
+		fprintf(stderr, "\n clean speech, scaled noise or features!");
+		print_usage(argv[0]);
+	}
+	if ((pars->prefetch < 0) || (pars->io_threads < 1))
+	{
+		fprintf(stderr, "\n\n Invalid number of prefetched files or I/O threads!");
+		print_usage(argv[0]);
+	}
 	if (pars->log_file == NULL)
 	{
 		pars->log_file = "filter_add_noise.log";
 	}
+	if (pars->kernels == NULL)
+	{
+		pars->kernels = (getenv("FANT_KERNELS") != NULL) ? getenv("FANT_KERNELS") : "auto";
+	}
 	if ((pars->mode & SAMP16K) && (pars->filter_type == P341))
 	{
 		pars->filter_type = P341_16K;
 	}
+	if ((pars->mode & SAMP48K) && (pars->filter_type == MIRS))
+	{
+		pars->filter_type = MIRS_48K;
+	}
 
 }
 
@@ -485,6 +897,11 @@ void print_usage(char *name)
 	fprintf(stderr,"\n\t\t(NOT giving a noise file means NO noise adding)");
 	fprintf(stderr,"\n\t-u\tto indicate and enable processing of 16 kHz data");
 	fprintf(stderr,"\n\t\t(Note: Only P.341 filtering can be applied in case of 16 kHz data!)");
+	fprintf(stderr,"\n\t--rate\t<rate> of the data: 8000 (default), 16000 (as -u), 32000 or 48000");
+	fprintf(stderr,"\n\t\t(S and N of 32 and 48 kHz data are estimated after downsampling to");
+	fprintf(stderr,"\n\t\t16 kHz, only MIRS filtering can be applied in case of 48 kHz data!)");
+	fprintf(stderr,"\n\t--noise-rate\t<rate> of raw noise files (default: as the speech); noise files");
+	fprintf(stderr,"\n\t\tat 8, 16, 32 or 48 kHz (WAV: rate of the header) are resampled on loading");
 	fprintf(stderr,"\n\t-m\t<mode> for estimating S and N");
 	fprintf(stderr,"\n\t\t(possible modes are: snr_4khz or snr_8khz or a_weight)");
 	fprintf(stderr,"\n\t\t(Note: S and N are estimated from the whole range up to 4 or up to 8 kHz");
@@ -504,6 +921,50 @@ void print_usage(char *name)
 	fprintf(stderr,"\n\t\t(NOT applying this option the seed is calculated from the actual time)");
 	fprintf(stderr,"\n\t-e\t<filename> of logfile");
 	fprintf(stderr,"\n\t-a\t<filename> of index list file");
+	fprintf(stderr,"\n\t--serve\t<socket> to keep the noise resident and serve mix requests");
+	fprintf(stderr,"\n\t\ton a UNIX socket (see fant-serve.h)");
+	fprintf(stderr,"\n\t--stream\tto process a sequence of framed utterances from stdin");
+	fprintf(stderr,"\n\t\tto stdout (see fant-stream.h)");
+	fprintf(stderr,"\n\t--prefetch\t<number> of speech files read ahead and of outputs");
+	fprintf(stderr,"\n\t\twritten behind in the background (default 4, 0: no background I/O)");
+	fprintf(stderr,"\n\t--io-threads\t<number> of threads for background I/O (default 2)");
+	fprintf(stderr,"\n\t--archive\t<filename> of an archive collecting all outputs");
+	fprintf(stderr,"\n\t\t(records named as in the output list or else the input list)");
+	fprintf(stderr,"\n\t--shard\t<number> of records per archive, files <archive>.0, .1, ...");
+	fprintf(stderr,"\n\t--manifest\t<filename> of a TSV or JSONL manifest with input, output,");
+	fprintf(stderr,"\n\t\tnoise, start, SNR and filter per utterance (see fant-manifest.h)");
+	fprintf(stderr,"\n\t--cache\t<filename> of a cache keeping the speech levels of the input");
+	fprintf(stderr,"\n\t\tfiles for later runs (see fant-cache.h)");
+	fprintf(stderr,"\n\t--cache-filtered\tto keep also the filtered speech in the cache");
+	fprintf(stderr,"\n\t--journal\t<filename> of a journal of the completed outputs");
+	fprintf(stderr,"\n\t--resume\tto skip the outputs completed according to the journal");
+	fprintf(stderr,"\n\t--failures\t<filename> of a report of the files that could not be");
+	fprintf(stderr,"\n\t\tprocessed (NOT applying this option means the program stops)");
+	fprintf(stderr,"\n\t--stats\t<filename> for a JSON summary of throughput, time per stage");
+	fprintf(stderr,"\n\t\tand file latency (see fant-stats.h)");
+	fprintf(stderr,"\n\t--trace\t<filename> for a timeline of all stages and threads");
+	fprintf(stderr,"\n\t\t(Chrome trace events, see fant-trace.h)");
+	fprintf(stderr,"\n\t--perf\t<filename> for a JSON report of cycles/sample, IPC and cache");
+	fprintf(stderr,"\n\t\tmiss rate per DSP kernel (see fant-perf.h)");
+	fprintf(stderr,"\n\t--results\t<filename> for a record of levels, SNR, overload and times");
+	fprintf(stderr,"\n\t\tper file, CSV if it ends in .csv, else JSON lines (see fant-results.h)");
+	fprintf(stderr,"\n\t--kernels\t<variant> of the DSP kernels: reference (ITU-T STL), auto (default,");
+	fprintf(stderr,"\n\t\tbest for the CPU), scalar, avx2 or avx512; else from FANT_KERNELS");
+	fprintf(stderr,"\n\t--explain\tto print the processing plan (stages of the measurement of");
+	fprintf(stderr,"\n\t\tS and N, output filter, gain and mix, quantization) and stop");
+	fprintf(stderr,"\n\t--clean\t<template> of the files of the filtered and normalized speech,");
+	fprintf(stderr,"\n\t\t%%s is replaced by the output name (e.g. %%s.clean)");
+	fprintf(stderr,"\n\t--scaled-noise\t<template> of the files of the scaled noise; clean speech and");
+	fprintf(stderr,"\n\t\tnoise add up to the output sample by sample");
+	fprintf(stderr,"\n\t--features\t<template> of the files of log-mel filterbank features of the");
+	fprintf(stderr,"\n\t\toutputs (see fant-feat.h), %%s is replaced by the output name");
+	fprintf(stderr,"\n\t--features-only\tto write the features instead of the outputs");
+	fprintf(stderr,"\n\t--feat-params\t<win>,<hop>,<bins>: frame length and shift in ms and number");
+	fprintf(stderr,"\n\t\tof mel filters (default 25,10,40)");
+	fprintf(stderr,"\n\t--big-endian\tfor raw inputs in big endian byte order (WAV inputs are");
+	fprintf(stderr,"\n\t\trecognized by their header, outputs named *.wav are WAV files)");
+	fprintf(stderr,"\n\t--format\t<format> of the outputs: int16 (default) or float32 (-1 ... 1, no");
+	fprintf(stderr,"\n\t\tquantization and no overload correction, the overload is only reported)");
 	fprintf(stderr,"\n");
 	exit(-1);
 }
@@ -521,14 +982,25 @@ void	write_logfile(PARAMETER *pars, FILE *fp)
 	fprintf(fp," Input list file: %s\n", pars->input_list);
 	fprintf(fp," Output list file: %s\n", pars->output_list);
 	fprintf(fp," Log file: %s\n", pars->log_file);
+	if (pars->archive != NULL)
+		fprintf(fp," Output archive: %s\n", pars->archive);
+	if (pars->manifest != NULL)
+		fprintf(fp," Manifest: %s\n", pars->manifest);
+	if (pars->cache != NULL)
+		fprintf(fp," Analysis cache: %s%s\n", pars->cache, pars->cache_filtered ? " (with filtered speech)" : "");
+	if (pars->journal != NULL)
+		fprintf(fp," Journal: %s%s\n", pars->journal, pars->resume ? " (resumed)" : "");
+	if (pars->failures != NULL)
+		fprintf(fp," Failure report: %s\n", pars->failures);
+	fprintf(fp," Kernels: %s (%s)\n", pars->kernels, fant_kernels.report);
 	// fprintf(stdout,"Program started on: %s", ctime(&tt));
 	// fprintf(stdout,"------------------------------------------------------\n");
 	// fprintf(stdout," Input list file: %s\n", pars->input_list);
 	// fprintf(stdout," Output list file: %s\n", pars->output_list);
 	// fprintf(stdout," Log file: %s\n", pars->log_file);
-	if (pars->mode & SAMP16K)
+	if (pars->mode & WIDEBAND)
 	{
-		fprintf(fp," Processing of 16 kHz data\n");
+		fprintf(fp," Processing of %d kHz data\n", sample_rate(pars->mode)/1000);
 		// fprintf(stdout," Processing of 16 kHz data\n");
 	}
 	else
@@ -595,57 +1067,56 @@ void	write_logfile(PARAMETER *pars, FILE *fp)
 }
 
 
-float *load_samples(FILE *fp, long *no_samples)
+/***  samples of a raw or WAV file, converted from its mapping  ***/
+/***  file_rate NULL: the file has to be at "rate", otherwise the rate of   ***/
+/*    raw files on input and of the file on return, resampled to "rate"   */
+float *load_samples(FILE *fp, long *no_samples, int rate, int *file_rate, int big_endian, const char *name)
 {
-     short *buf;
-	float *sig;
-	
-	buf=load_short_samples(fp,no_samples);
+	FANT_AUDIO audio;
+	float     *sig;
+	int        ret;
 
-	if ( ( sig = (float*)calloc((size_t)*no_samples, sizeof(float))) == NULL)
+	if ( (ret = fant_read_audio(fp, 1, big_endian, &audio)) != FANT_OK)
 	{
-		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		if (ret == FANT_ERR_MEMORY)
+			fprintf(stderr, "cannot reallocate enough memory to buffer samples!\n");
+		else
+			fprintf(stderr, "\n%s is no 16 bit mono PCM WAV file\n\n", name);
 		exit(-1);
 	}
-	sh2fl_16bit(*no_samples, buf, sig, 1);
-	free(buf);
-	return(sig);
-}
-
-short *load_short_samples(FILE *fp, long *no_samples)
-{
-    short *buf;
-    size_t unit = 1048576, readed;
-    void *newPtr = NULL;
-    *no_samples=0;
-	
-	if ( ( buf = (short*)calloc((size_t)unit, sizeof(short))) == NULL)
+	if ( (audio.rate > 0) && (audio.rate != rate) && (file_rate == NULL) )
+	{
+		fprintf(stderr, "\n%s has a sample rate of %d Hz, not %d Hz (-u, --rate)\n\n", name, audio.rate, rate);
+		exit(-1);
+	}
+	*no_samples = audio.no_samples;
+	if ( ( sig = (float*)calloc((size_t)*no_samples+1, sizeof(float))) == NULL)
 	{
 		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
 		exit(-1);
 	}
-
-	while ( (readed = fread(buf+*no_samples, sizeof(short), (size_t)unit, fp)) != 0 )
+	FANT_PERF_CALL(FANT_K_SH2FL, *no_samples, fant_kernels.sh2fl(*no_samples, audio.samples, sig));
+	fant_audio_free(&audio);
+	if (file_rate == NULL)
+		return(sig);
+	if (audio.rate > 0)
+		*file_rate = audio.rate;
+	if ( (*file_rate != rate) && ( (ret = resample_samples(&sig, no_samples, *file_rate, rate)) != FANT_OK) )
 	{
-		*no_samples += readed;
-		unit += unit;
-
-		if ((newPtr = realloc(buf, (*no_samples + unit) * sizeof (short))) != NULL)
-		    buf = (short*) newPtr;
+		if (ret == FANT_ERR_MEMORY)
+			fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
 		else
-		{
-			free(buf);
-			fprintf(stderr, "cannot reallocate enough memory to buffer samples!\n");
-			exit(-1);
-		}
+			fprintf(stderr, "\ncannot resample %s from %d Hz to %d Hz (8, 16, 32 or 48 kHz)\n\n", name, *file_rate, rate);
+		exit(-1);
 	}
-	return (short*)realloc(buf, (*no_samples + 1)*sizeof(short));
+	return(sig);
 }
 
-void  write_samples(float *sig, long no_samples, char *name)
+void  write_samples(float *sig, long no_samples, char *name, int rate, int float32)
 {
     FILE *fp;
 	short *buf;
+	int    ret;
 	
 	if (name == NULL)
 	{
@@ -657,484 +1128,42 @@ void  write_samples(float *sig, long no_samples, char *name)
 		exit(-1);
 	}
 	
-	if ( ( buf = (short*)calloc((size_t)no_samples, sizeof(short))) == NULL)
+	if ( (name == NULL) || !fant_wav_name(name) )
+		rate = 0;
+	if (float32)  /* no quantization buffer */
+		ret = fant_write_float(fp, sig, no_samples, rate);
+	else
 	{
-		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
-		exit(-1);
+		if ( ( buf = (short*)calloc((size_t)no_samples, sizeof(short))) == NULL)
+		{
+			fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+			exit(-1);
+		}
+		FANT_PERF_CALL(FANT_K_FL2SH, no_samples, fant_kernels.fl2sh(no_samples, sig, buf));
+		ret = fant_write_audio(fp, buf, no_samples, rate);
+		free(buf);
 	}
-	fl2sh_16bit(no_samples, sig, buf, 1);
-	if ( fwrite(buf, sizeof(short), (size_t)no_samples, fp) != no_samples )
+	if (ret != FANT_OK)
 	{
 		fprintf(stderr, "could not write all samples to file %s!\n", name);
 		exit(-1);
 	}
-	free(buf);
 	fclose(fp);
 }
 
-void filter_samples(float *signal, long no_samples, int type)
-{
-    CASCADE_IIR *g712_state;
-	SCD_FIR     *p341_state, *irs_state, *mirs_state, *up_ptr, *down_ptr;
-	float  *buf, *buf1, *buf2, *signal_buf;
-	long    no=0, filter_shift=0;
-	
-    switch(type)
-	{
-	  case G712:
-	  case G712_16K:
-		filter_shift = 0;
-		break;
-	  case P341:
-		filter_shift = P341_FILTER_SHIFT;
-		break;
-	  case IRS:
-		filter_shift = IRS_FILTER_SHIFT;
-		break;
-	  case MIRS:
-		filter_shift = MIRS_FILTER_SHIFT;
-		break;
-	  case P341_16K:
-		filter_shift = P341_16K_FILTER_SHIFT;
-		break;
-	}
-	
-	if ( ( buf = (float*)calloc((size_t)(no_samples+filter_shift), sizeof(float))) == NULL)
-	{
-		fprintf(stderr, "cannot allocate enough memory to filter samples!\n");
-		exit(-1);
-	}
-	if ( ( signal_buf = (float*)calloc((size_t)(no_samples+filter_shift), sizeof(float))) == NULL)
-	{
-		fprintf(stderr, "cannot reallocate enough memory to filter samples!\n");
-		exit(-1);
-	}
-	memcpy(signal_buf, signal, (size_t)(no_samples*sizeof(float)));
-	switch(type)
-	{
-	  case G712:
-		g712_state = iir_G712_8khz_init();
-		no = cascade_iir_kernel((no_samples+filter_shift), signal_buf, g712_state, buf);
-		cascade_iir_free(g712_state);
-		/* next lines only for testing the A weighting filter
-		AWeightFil(signal_buf, no_samples, 16000);
-		no = no_samples;
-		memcpy(buf, signal_buf, (size_t)(no_samples*sizeof(float))); */
-		break;
-	  case P341:
-		p341_state = fir_hp_8khz_init();
-		no = hq_kernel((no_samples+filter_shift), signal_buf, p341_state, buf);
-		hq_free(p341_state);
-		break;
-	  case IRS:
-		irs_state = irs_8khz_init();
-		no = hq_kernel((no_samples+filter_shift), signal_buf, irs_state, buf);
-		hq_free(irs_state);
-		break;
-	  case MIRS:
-		mirs_state = mod_irs_16khz_init();
-		up_ptr = hq_up_1_to_2_init();
-		down_ptr = hq_down_2_to_1_init();
-		if ( ( buf1 = (float*)calloc((size_t)2*(no_samples+filter_shift), sizeof(float))) == NULL)
-		{
-			fprintf(stderr, "cannot allocate enough memory to filter samples!\n");
-			exit(-1);
-		}
-		if ( ( buf2 = (float*)calloc((size_t)2*(no_samples+filter_shift), sizeof(float))) == NULL)
-		{
-			fprintf(stderr, "cannot allocate enough memory to filter samples!\n");
-			exit(-1);
-		}
-		no = hq_kernel((no_samples+filter_shift), signal_buf, up_ptr, buf1);
-		no = hq_kernel(2 * (no_samples+filter_shift), buf1, mirs_state, buf2);
-		no = hq_kernel(2 * (no_samples+filter_shift), buf2, down_ptr, buf);
-		hq_free (up_ptr);
-		hq_free (mirs_state);
-		hq_free (down_ptr);
-		free(buf1);
-		free(buf2);
-		break;
-	  case G712_16K:
-		g712_state = iir_G712_8khz_init();
-		down_ptr = hq_down_2_to_1_init();
-		if ( ( buf1 = (float*)calloc((size_t)((no_samples+1)/2+filter_shift), sizeof(float))) == NULL)
-		{
-			fprintf(stderr, "cannot allocate enough memory to filter samples!\n");
-			exit(-1);
-		}
-		no = hq_kernel((no_samples+filter_shift), signal_buf, down_ptr, buf1);
-		no_samples /= 2;
-		no = cascade_iir_kernel((no_samples+filter_shift), buf1, g712_state, buf);
-		cascade_iir_free(g712_state);
-		hq_free (down_ptr);
-		free(buf1);
-		break;
-	  case P341_16K:
-		p341_state = p341_16khz_init();
-		no = hq_kernel((no_samples+filter_shift), signal_buf, p341_state, buf);
-		hq_free(p341_state);
-		break;
-	  case DOWN:
-		down_ptr = hq_down_2_to_1_init();
-		no = hq_kernel((no_samples+filter_shift), signal_buf, down_ptr, buf);
-		no_samples /= 2;
-		hq_free (down_ptr);
-		break;
-	}
-	if (no != (no_samples+filter_shift))
-		fprintf(stderr, "Number of samples at output of filtering NOT equal to number of input samples!\n");
-	memcpy(signal, &buf[filter_shift], (size_t)(no_samples*sizeof(float)));
-	free(buf);
-	free(signal_buf);
-}
-
-/***  DC offset compensation filtering  ***/
-void DCOffsetFil(float *signal, long no_samples, int samp_freq)
-{
-  long i;
-  float aux, prev_x, prev_y, coeff;
-
-  if (samp_freq == 8000)
-  {
-  	/* y[n] = x[n] - x[n-1] + 0.999 * y[n-1] */
-	coeff = 0.999;
-  }
-  else
-  {
-  	/* y[n] = x[n] - x[n-1] + 0.9995 * y[n-1] */
-	coeff = 0.9995;
-  }
-
-  prev_x = 0.;
-  prev_y = 0.;
-  for (i=0 ; i<no_samples ; i++)
-        {
-          aux = signal[i];
-          signal[i] = signal[i] - prev_x + 0.999 * prev_y;
-          prev_x = aux;
-          prev_y = signal[i];
-        }
-}
-
-/***  A weighting filter  ***/
-/* The filter characteristic of the A-weighting is realized as
-   a combination of a 2nd order IIR HP filter and a FIR filter.
-   The filters have been designed with MATLAB to match
-   Ra(f) = 12200^2*f^4 / ( (f^2+20.6^2)*(f^2+12200^2)*sqrt(f^2+107.7^2)*sqrt(f^2+737.9^2) )
-*/
-void AWeightFil(float *signal, long no_samples, int samp_freq)
-{
-  long i, j;
-  int nrfircoef, nr2;
-  double aux, prev_x1, prev_y1, prev_x2, prev_y2, sig;
-  double *b, *b1, *a1, *buf;
-/* coefficients of HP IIR filter for 8 kHz */
-double b1_8[3] = { 0.97803047920655972192, -1.95606095841311944383,  0.97803047920655972192};
-double a1_8[3] = { 1.00000000000000000000, -1.95557824031503546536,  0.95654367651120331129};
-/* coefficients of HP IIR filter for 16 kHz */
-double b1_16[3] = { 0.98211268665798745481, -1.96422537331597490962,  0.98211268665798745481};
-double a1_16[3] = { 1.00000000000000000000, -1.96390539174032729974,  0.96454535489162229744};
-/* coefficients of FIR filter for 8 kHz */
-double b_8[401] = {  \
-	-0.00000048447483696946, -0.00000022512318749614, -0.00000026294025838101, \
-	 0.00000001064770950293,  0.00000003833470677151,  0.00000051126078952589, \
-	 0.00000069953309206104,  0.00000098541838241537,  0.00000081475746826278, \
-	 0.00000071268849316663,  0.00000047296424495409,  0.00000045167560549269, \
-	 0.00000025625324551665,  0.00000029659517075128,  0.00000012973089907994, \
-	 0.00000021259865101836,  0.00000006731555126460,  0.00000020685105369918, \
-	 0.00000011425817192679,  0.00000041296073931891,  0.00000044791493633252, \
-	 0.00000070403634084571,  0.00000055460203484093,  0.00000059180030971632, \
-	 0.00000037291369217390,  0.00000043930757040800,  0.00000022350428357547, \
-	 0.00000032417428619399,  0.00000010931231083113,  0.00000023960656238246, \
-	 0.00000002518603320581,  0.00000020360644134332,  0.00000002294875525823, \
-	 0.00000036684242335179,  0.00000032206388036039,  0.00000067239882378009, \
-	 0.00000047076577332115,  0.00000062355204864449,  0.00000033329059818567, \
-	 0.00000049980041816919,  0.00000019054258683724,  0.00000038619575844507, \
-	 0.00000005987624410169,  0.00000028352923650070, -0.00000006065134972245, \
-	 0.00000021066197086678, -0.00000011559068267007,  0.00000035187682882953, \
-	 0.00000018911184032816,  0.00000071185755567156,  0.00000039628928325198, \
-	 0.00000071727603322036,  0.00000028502865756631,  0.00000061047935453455, \
-	 0.00000013533215782697,  0.00000048963932090098, -0.00000002412770048109, \
-	 0.00000035905116933378, -0.00000019714163211650,  0.00000023343303301514, \
-	-0.00000032883174661595,  0.00000034112098540144, -0.00000002013183789564, \
-	 0.00000076876433367610,  0.00000025451747786098,  0.00000083392066985720, \
-	 0.00000016702345929555,  0.00000074451146044984,  0.00000000368726942094, \
-	 0.00000061262145802736, -0.00000019658915230727,  0.00000044360091722352, \
-	-0.00000044388652434922,  0.00000024103770006125, -0.00000069300296642645, \
-	 0.00000028299231855406, -0.00000040858734051716,  0.00000077228655642159, \
-	-0.00000007206267809928,  0.00000089818974605587, -0.00000014399904288098, \
-	 0.00000082277817797847, -0.00000033588376942978,  0.00000066948742873521, \
-	-0.00000060057886334042,  0.00000044146432002551, -0.00000096039560383583, \
-	 0.00000012053414322732, -0.00000139567180432868,  0.00000003499817058916, \
-	-0.00000120127431401377,  0.00000054929811663290, -0.00000084136392860322, \
-	 0.00000071187362632263, -0.00000093656445044485,  0.00000062086550172766, \
-	-0.00000120620094216959,  0.00000040541476845153, -0.00000159893445870286, \
-	 0.00000006116939341500, -0.00000215817883874979, -0.00000046805016014766, \
-	-0.00000291567502959354, -0.00000081034476310266, -0.00000295972826281522, \
-	-0.00000038208445373341, -0.00000270158074324256, -0.00000028610530331721, \
-	-0.00000295437553011978, -0.00000051213557187288, -0.00000346084232168490, \
-	-0.00000093544688046448, -0.00000417377051206647, -0.00000157785035711933, \
-	-0.00000517283917494427, -0.00000256013415986944, -0.00000658452041834079, \
-	-0.00000348617114338415, -0.00000725051504153352, -0.00000348145442182330, \
-	-0.00000748452095899366, -0.00000381670662519333, -0.00000833912676894361, \
-	-0.00000460581537897684, -0.00000960803218461066, -0.00000575052259069264, \
-	-0.00001126971690354723, -0.00000731471724310772, -0.00001347382962085700, \
-	-0.00000953631917028709, -0.00001652423778949483, -0.00001204562230261030, \
-	-0.00001898108292544097, -0.00001359523368806706, -0.00002102023713909460, \
-	-0.00001567362600146969, -0.00002402916745522739, -0.00001859827094821024, \
-	-0.00002792481555180809, -0.00002236632163891675, -0.00003278682614223167, \
-	-0.00002716785941170217, -0.00003894078939793811, -0.00003350000474485616, \
-	-0.00004707261529101495, -0.00004117953534261129, -0.00005549229201502203, \
-	-0.00004854831975713259, -0.00006428602304202158, -0.00005751749178242488, \
-	-0.00007547082178730966, -0.00006888306835026006, -0.00008937608730225377, \
-	-0.00008304065366192661, -0.00010653315756608934, -0.00010069556565277376, \
-	-0.00012791706451173652, -0.00012317597326295306, -0.00015534957920904628, \
-	-0.00015119559113842406, -0.00018743511243768355, -0.00018315735451190256, \
-	-0.00022492450567979631, -0.00022252894483161461, -0.00027191753804259159, \
-	-0.00027210151946550513, -0.00033091855632192026, -0.00033462449100590694, \
-	-0.00040528057920629279, -0.00041401099044859757, -0.00049996344641314633, \
-	-0.00051634251110413301, -0.00062296124512021081, -0.00064870975228481043, \
-	-0.00077929439175705522, -0.00081642092721146428, -0.00097961081175696862, \
-	-0.00103615592056275404, -0.00124532298732607061, -0.00133067510583451858, \
-	-0.00160455574020486129, -0.00173377904846212577, -0.00210208956880716599, \
-	-0.00230122036337402887, -0.00281419951501742224, -0.00313155247940679650, \
-	-0.00388062211113633822, -0.00440501290142665362, -0.00555548659253778630, \
-	-0.00647018812272768650, -0.00837591414127070166, -0.01010231987300322896, \
-	-0.01356061827384147031, -0.01708437456947442534, -0.02402258013383605159, \
-	-0.03176179634779018046, -0.04725099052436917274, -0.06500419192239298427, \
-	-0.10495713406978124382, -0.13001585049351535583,  1.00202934757439754421, \
-	-0.13001585049351260803, -0.10495713406978261772, -0.06500419192239276223, \
-	-0.04725099052436897151, -0.03176179634779023597, -0.02402258013383685303, \
-	-0.01708437456947343655, -0.01356061827384207226, -0.01010231987300251599, \
-	-0.00837591414127101912, -0.00647018812272795105, -0.00555548659253785135, \
-	-0.00440501290142657816, -0.00388062211113645011, -0.00313155247940646083, \
-	-0.00281419951501782339, -0.00230122036337384803, -0.00210208956880718334, \
-	-0.00173377904846190763, -0.00160455574020492830, -0.00133067510583440777, \
-	-0.00124532298732645832, -0.00103615592056261765, -0.00097961081175704668, \
-	-0.00081642092721146472, -0.00077929439175693650, -0.00064870975228487461, \
-	-0.00062296124512023910, -0.00051634251110382412, -0.00049996344641339472, \
-	-0.00041401099044828212, -0.00040528057920655793, -0.00033462449100599172, \
-	-0.00033091855632189261, -0.00027210151946566391, -0.00027191753804250599, \
-	-0.00022252894483150621, -0.00022492450567991013, -0.00018315735451169751, \
-	-0.00018743511243781582, -0.00015119559113829513, -0.00015534957920906756, \
-	-0.00012317597326292961, -0.00012791706451191086, -0.00010069556565275803, \
-	-0.00010653315756613178, -0.00008304065366182717, -0.00008937608730207478, \
-	-0.00006888306835033379, -0.00007547082178731399, -0.00005751749178236594, \
-	-0.00006428602304224104, -0.00004854831975686155, -0.00005549229201534046, \
-	-0.00004117953534267964, -0.00004707261529099294, -0.00003350000474499829, \
-	-0.00003894078939759813, -0.00002716785941168689, -0.00003278682614236486, \
-	-0.00002236632163880632, -0.00002792481555207722, -0.00001859827094805007, \
-	-0.00002402916745519642, -0.00001567362600153142, -0.00002102023713907599, \
-	-0.00001359523368790508, -0.00001898108292530993, -0.00001204562230221977, \
-	-0.00001652423778936245, -0.00000953631917073583, -0.00001347382962091341, \
-	-0.00000731471724375662, -0.00001126971690382800, -0.00000575052259002190, \
-	-0.00000960803218588184, -0.00000460581537765319, -0.00000833912676879278, \
-	-0.00000381670662386180, -0.00000748452096203882, -0.00000348145442048370, \
-	-0.00000725051504105103, -0.00000348617114306444, -0.00000658452041804100, \
-	-0.00000256013416030796, -0.00000517283917536835, -0.00000157785035723070, \
-	-0.00000417377051229723, -0.00000093544688056833, -0.00000346084232157659, \
-	-0.00000051213557197883, -0.00000295437552986686, -0.00000028610530303880, \
-	-0.00000270158074328942, -0.00000038208445346697, -0.00000295972826305478, \
-	-0.00000081034476315829, -0.00000291567502957262, -0.00000046805016033679, \
-	-0.00000215817883858096,  0.00000006116939340522, -0.00000159893445868161, \
-	 0.00000040541476858004, -0.00000120620094225548,  0.00000062086550181404, \
-	-0.00000093656445052059,  0.00000071187362625699, -0.00000084136392873181, \
-	 0.00000054929811657256, -0.00000120127431400949,  0.00000003499817062538, \
-	-0.00000139567180421291,  0.00000012053414316903, -0.00000096039560378374, \
-	 0.00000044146432006458, -0.00000060057886339091,  0.00000066948742887569, \
-	-0.00000033588376961814,  0.00000082277817799631, -0.00000014399904286968, \
-	 0.00000089818974600899, -0.00000007206267791168,  0.00000077228655631520, \
-	-0.00000040858734051298,  0.00000028299231857979, -0.00000069300296651602, \
-	 0.00000024103770018627, -0.00000044388652449250,  0.00000044360091722030, \
-	-0.00000019658915231848,  0.00000061262145802356,  0.00000000368726950959, \
-	 0.00000074451146042521,  0.00000016702345934702,  0.00000083392066980561, \
-	 0.00000025451747789236,  0.00000076876433370927, -0.00000002013183795176, \
-	 0.00000034112098553517, -0.00000032883174674481,  0.00000023343303310152, \
-	-0.00000019714163212011,  0.00000035905116921998, -0.00000002412770030070, \
-	 0.00000048963932070069,  0.00000013533215787171,  0.00000061047935452411, \
-	 0.00000028502865736597,  0.00000071727603351564,  0.00000039628928307606, \
-	 0.00000071185755575744,  0.00000018911184033621,  0.00000035187682854291, \
-	-0.00000011559068225173,  0.00000021066197066498, -0.00000006065134949705, \
-	 0.00000028352923609170,  0.00000005987624482286,  0.00000038619575789876, \
-	 0.00000019054258687088,  0.00000049980041800381,  0.00000033329059839068, \
-	 0.00000062355204865072,  0.00000047076577331007,  0.00000067239882386183, \
-	 0.00000032206388025069,  0.00000036684242346853,  0.00000002294875522055, \
-	 0.00000020360644131705,  0.00000002518603326988,  0.00000023960656229525, \
-	 0.00000010931231087879,  0.00000032417428617176,  0.00000022350428353128, \
-	 0.00000043930757046438,  0.00000037291369211717,  0.00000059180030972943, \
-	 0.00000055460203483238,  0.00000070403634081861,  0.00000044791493638141, \
-	 0.00000041296073931221,  0.00000011425817192819,  0.00000020685105369570, \
-	 0.00000006731555124485,  0.00000021259865104789,  0.00000012973089908160, \
-	 0.00000029659517075261,  0.00000025625324549990,  0.00000045167560549383, \
-	 0.00000047296424497843,  0.00000071268849317641,  0.00000081475746827296, \
-	 0.00000098541838238358,  0.00000069953309205412,  0.00000051126078953913, \
-	 0.00000003833470675649,  0.00000001064770952157, -0.00000026294025842014, \
-	-0.00000022512318749586, -0.00000048447483693658 };
-/* coefficients of FIR filter for 16 kHz */
-double b_16[301] = {  \
-	-0.00000163823566567235, -0.00000129349101568055, -0.00000173855867999297, \
-	-0.00000138886083315020, -0.00000186074944599914, -0.00000150193139198946, \
-	-0.00000200604496185638, -0.00000163127987422071, -0.00000217132557278059, \
-	-0.00000176741808887155, -0.00000234382073006229, -0.00000183094344655654, \
-	-0.00000250084283910075, -0.00000199864660566820, -0.00000262789002458754, \
-	-0.00000215386043860660, -0.00000289217185109260, -0.00000239378523373080, \
-	-0.00000322662206448115, -0.00000269434283679307, -0.00000362531450279619, \
-	-0.00000305075217416252, -0.00000408817430627477, -0.00000346416689290217, \
-	-0.00000461920770121783, -0.00000393932206526000, -0.00000522530308400259, \
-	-0.00000448351321445257, -0.00000591564184061565, -0.00000510612699627384, \
-	-0.00000670136346012773, -0.00000581822564278744, -0.00000759496947841621, \
-	-0.00000663144143348438, -0.00000860841360320021, -0.00000755451505352295, \
-	-0.00000974743477173025, -0.00000858432874211604, -0.00001099850081772816, \
-	-0.00000951231180346016, -0.00001227514374058944, -0.00001069770708620096, \
-	-0.00001351961693721276, -0.00001190082625789161, -0.00001508067422270440, \
-	-0.00001334654683810277, -0.00001689161756572877, -0.00001502283369917000, \
-	-0.00001895702883557266, -0.00001693675311730079, -0.00002129105878855550, \
-	-0.00001910487054790810, -0.00002391661786573805, -0.00002155212349973529, \
-	-0.00002686481719856254, -0.00002431145023492758, -0.00003017501508719200, \
-	-0.00002742414172429308, -0.00003389545048083550, -0.00003094066284628364, \
-	-0.00003808392712044369, -0.00003492107295288400, -0.00004280677257843587, \
-	-0.00003943266482462276, -0.00004813086069643492, -0.00004454795915910790, \
-	-0.00005411064105123142, -0.00004978108057728533, -0.00006053146558008195, \
-	-0.00005591629066482250, -0.00006726077312005088, -0.00006247107842621700, \
-	-0.00007501845211855596, -0.00006996429387079926, -0.00008383355250755138, \
-	-0.00007848989593105642, -0.00009381300436270244, -0.00008815897211855582, \
-	-0.00010508611888928092, -0.00009910600683043637, -0.00011781065580099466, \
-	-0.00011149480231451605, -0.00013217771097594411, -0.00012552361433682034, \
-	-0.00014841748019445592, -0.00014143186724447642, -0.00016680726333668429, \
-	-0.00015950964206924115, -0.00018768220029857365, -0.00018011048605059599, \
-	-0.00021144733901080876, -0.00020366775396491089, -0.00023858297765662684, \
-	-0.00023076411910554420, -0.00026970431005075987, -0.00026068439401730485, \
-	-0.00030470598160643134, -0.00029539153470893316, -0.00034372546700033225, \
-	-0.00033441055096840278, -0.00038864335568094714, -0.00037937084585191045, \
-	-0.00044046553493560527, -0.00043137871260839591, -0.00050044145280684585, \
-	-0.00049173817484151965, -0.00057009787755619838, -0.00056205601515835267, \
-	-0.00065134093406154082, -0.00064435205571055265, -0.00074658366829230961, \
-	-0.00074120024680015531, -0.00085891975554849679, -0.00085592507999440650, \
-	-0.00099237016459549198, -0.00099288457416451940, -0.00115224073327841446, \
-	-0.00115788645226965956, -0.00134564572909820685, -0.00135881539184466910, \
-	-0.00158226727446100215, -0.00160686124447576299, -0.00187589512010747717, \
-	-0.00191361708126458496, -0.00224313077365659395, -0.00230285969530687976, \
-	-0.00270869448954760448, -0.00280161130222293274, -0.00331284571947834715, \
-	-0.00345545877593055615, -0.00411288499378428731, -0.00433074047660635814, \
-	-0.00519546795915075323, -0.00552823600867017109, -0.00669413267342846511, \
-	-0.00720362577421732476, -0.00881837437615939912, -0.00960052818708471110, \
-	-0.01190264418816686619, -0.01310369434291633675, -0.01649112537915961921, \
-	-0.01832242291243315474, -0.02349169549765109388, -0.02620808279888530226, \
-	-0.03448966393581323620, -0.03812774396888992529, -0.05263240033584821315, \
-	-0.05486415897428192912, -0.08877452476680040838, -0.01261484753501346777, \
-	 1.00356872825050946751, -0.01261484753503031193, -0.08877452476679281723, \
-	-0.05486415897428669614, -0.05263240033584432043, -0.03812774396889240247, \
-	-0.03448966393581100881, -0.02620808279888764414, -0.02349169549764856813, \
-	-0.01832242291243483048, -0.01649112537915836327, -0.01310369434291740708, \
-	-0.01190264418816549055, -0.00960052818708617174, -0.00881837437615880758, \
-	-0.00720362577421778446, -0.00669413267342735836, -0.00552823600867079299, \
-	-0.00519546795915030307, -0.00433074047660710320, -0.00411288499378345464, \
-	-0.00345545877593135715, -0.00331284571947772829, -0.00280161130222301470, \
-	-0.00270869448954737420, -0.00230285969530739628, -0.00224313077365622315, \
-	-0.00191361708126515785, -0.00187589512010717446, -0.00160686124447636755, \
-	-0.00158226727446038416, -0.00135881539184473936, -0.00134564572909785601, \
-	-0.00115788645226987423, -0.00115224073327792136, -0.00099288457416505543, \
-	-0.00099237016459540590, -0.00085592507999461337, -0.00085891975554801476, \
-	-0.00074120024680079542, -0.00074658366829181760, -0.00064435205571094784, \
-	-0.00065134093406116699, -0.00056205601515879231, -0.00057009787755602219, \
-	-0.00049173817484126367, -0.00050044145280631915, -0.00043137871260933070, \
-	-0.00044046553493469183, -0.00037937084585278541, -0.00038864335568060160, \
-	-0.00033441055096828900, -0.00034372546700017510, -0.00029539153470938310, \
-	-0.00030470598160636098, -0.00026068439401741235, -0.00026970431005102376, \
-	-0.00023076411910555691, -0.00023858297765633738, -0.00020366775396491997, \
-	-0.00021144733901044975, -0.00018011048605068918, -0.00018768220029861783, \
-	-0.00015950964206965665, -0.00016680726333593294, -0.00014143186724488663, \
-	-0.00014841748019449227, -0.00012552361433689789, -0.00013217771097567499, \
-	-0.00011149480231447122, -0.00011781065580081225, -0.00009910600683070414, \
-	-0.00010508611888905710, -0.00008815897211896660, -0.00009381300436261302, \
-	-0.00007848989593102117, -0.00008383355250745122, -0.00006996429387099301, \
-	-0.00007501845211851302, -0.00006247107842627319, -0.00006726077311992514, \
-	-0.00005591629066486161, -0.00006053146558001904, -0.00004978108057739705, \
-	-0.00005411064105111847, -0.00004454795915914179, -0.00004813086069638520, \
-	-0.00003943266482468589, -0.00004280677257856477, -0.00003492107295277574, \
-	-0.00003808392712035809, -0.00003094066284633193, -0.00003389545048065900, \
-	-0.00002742414172435651, -0.00003017501508728730, -0.00002431145023493965, \
-	-0.00002686481719855991, -0.00002155212349960679, -0.00002391661786585488, \
-	-0.00001910487054809171, -0.00002129105878838215, -0.00001693675311722188, \
-	-0.00001895702883560177, -0.00001502283369927165, -0.00001689161756547775, \
-	-0.00001334654683827559, -0.00001508067422280056, -0.00001190082625786406, \
-	-0.00001351961693711764, -0.00001069770708634584, -0.00001227514374056167, \
-	-0.00000951231180320429, -0.00001099850081810239, -0.00000858432874199897, \
-	-0.00000974743477169181, -0.00000755451505353840, -0.00000860841360316040, \
-	-0.00000663144143354042, -0.00000759496947838709, -0.00000581822564273562, \
-	-0.00000670136346019077, -0.00000510612699626390, -0.00000591564184057631, \
-	-0.00000448351321447595, -0.00000522530308401066, -0.00000393932206526943, \
-	-0.00000461920770117965, -0.00000346416689293377, -0.00000408817430624457, \
-	-0.00000305075217416854, -0.00000362531450277131, -0.00000269434283683277, \
-	-0.00000322662206448276, -0.00000239378523369839, -0.00000289217185106983, \
-	-0.00000215386043867678, -0.00000262789002454381, -0.00000199864660567825, \
-	-0.00000250084283909178, -0.00000183094344656972, -0.00000234382073002803, \
-	-0.00000176741808886073, -0.00000217132557281426, -0.00000163127987426894, \
-	-0.00000200604496179164, -0.00000150193139199939, -0.00000186074944604085, \
-	-0.00000138886083315537, -0.00000173855867992306, -0.00000129349101569237, \
-	-0.00000163823566572743 };
-
-  if (samp_freq == 8000)
-  {
-	b = b_8;
-	b1 = b1_8;
-	a1 = a1_8;
-	nrfircoef = 401;
-  }
-  else
-  {
-	b = b_16;
-	b1 = b1_16;
-	a1 = a1_16;
-	nrfircoef = 301;
-  }
-
-  nr2 = (int)nrfircoef/2;
-  if ( ( buf = (double*)calloc((size_t)(no_samples+nrfircoef-1), sizeof(double))) == NULL)
-  {
-	fprintf(stderr, "cannot allocate enough memory to filter samples!\n");
-	exit(-1);
-  }
-
-  /* IIR filter 2nd order */
-  prev_x1 = 0.;
-  prev_y1 = 0.;
-  prev_x2 = 0.;
-  prev_y2 = 0.;
-  for (i=0 ; i<no_samples ; i++)
-  {
-  	aux = (double)signal[i];
-	buf[i+nr2] = (double)signal[i]*b1[0] + prev_x1*b1[1] + prev_x2*b1[2];
-	buf[i+nr2] -= (a1[1] * prev_y1 + a1[2] * prev_y2);
-        prev_x2 = prev_x1;
-        prev_x1 = aux;
-        prev_y2 = prev_y1;
-        prev_y1 = buf[i+nr2];
-  }
-
-  /* FIR filter */
-  for (i=0 ; i<no_samples ; i++)
-  {
-	sig = 0.;
-  	for (j=0 ; j<nrfircoef ; j++)
-  	{
-	   sig += b[j]*buf[i+j];
-	}
-	signal[i] = (float) sig;
-  }
-  free(buf);
-}
-
 void process_one_file(PARAMETER	pars,char *filename,char *out_filename,
-	long no_noise_samples,float *noise,float *noise_g712,
-	FILE *fp_index,FILE *fp_log)
+	FANT_CONTEXT *ctx,FILE *fp_index,FILE *fp_log)
 {
 	FILE        *fp_speech;
-	long       no_speech_samples, no, start, i;
-	float      *speech, *speech_two_pass, *noise_buf;
-	SVP56_state volt_state;
-	double      speech_level, noise_level, factor, fmax, snr;
-	int         count;
+	long         no_speech_samples;
+	float       *speech;
+	FANT_REQUEST req;
+	FANT_RESULT  res;
+	int          ret;
+	double       t0, t_read, t1;
+
+		t0 = fant_time();
+		fant_trace_file((filename == NULL) ? "stdin" : filename);
 		if (filename == NULL)
 		{
 			fp_speech = stdin;
@@ -1145,264 +1174,943 @@ void process_one_file(PARAMETER	pars,char *filename,char *out_filename,
 			exit(-1);
 		}
 
-		/* load samples of speech signal for calculating speech level S */
-		speech = load_samples(fp_speech, &no_speech_samples);
-		if ( ( speech_two_pass = (float*)calloc((size_t)no_speech_samples, sizeof(float))) == NULL)
+		/* load samples of speech signal */
+		speech = load_samples(fp_speech, &no_speech_samples, ctx->plan.rate, NULL, pars.big_endian, (filename == NULL) ? "stdin" : filename);
+		t_read = fant_time() - t0;
+		FANT_TRACE("read", t0, t0 + t_read);
+
+		fant_default_request(&req);
+		req.keep_overload = pars.float32;
+		if (draw_request(&pars, ctx, no_speech_samples, fp_index, &req) != FANT_OK)
 		{
-			fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+			fprintf(stderr, "\nInsufficient number of indices defined in index list file!\n");
 			exit(-1);
 		}
-		memcpy(speech_two_pass,speech,sizeof(float)*no_speech_samples);
 
-		if (pars.mode & SAMP16K)  /*  16 kHz data  */
-		{
-		    if (pars.mode & SNR_4khz)  /*  full 4 kHz bandwidth for calculating speech level S  */
-		    {
-			filter_samples(speech, no_speech_samples, DOWN);  /*  downsampling  16 --> 8 kHz  */
-		    }
-		    else if (pars.mode & A_WEIGHT)
-		    {
-		        AWeightFil(speech, no_speech_samples, 16000);
-		    }
-		    else if (pars.mode & SNR_8khz)
-		    {
-		    }
-		    else
-		    {
-		  	filter_samples(speech, no_speech_samples, G712_16K); /*  G.712 filtering of 16 K data  */
-		    }
-		    if (pars.mode & SNR_8khz)  /* FULL 8 kHz bandwidth */
-		    {
-			init_speech_voltmeter(&volt_state, 16000.);
-			if (pars.mode & DC_COMP)
-				DCOffsetFil(speech, no_speech_samples, 16000);
-		  	speech_level = speech_voltmeter(speech, no_speech_samples, &volt_state);
-		    }
-		    else
-		    {
-			init_speech_voltmeter(&volt_state, 8000.);
-			if ( (pars.mode & DC_COMP) && (!(pars.mode & A_WEIGHT)) )
-				DCOffsetFil(speech, no_speech_samples/2, 8000);
-		  	speech_level = speech_voltmeter(speech, no_speech_samples/2, &volt_state);
-		    }
-		}
-		else  /*  8 kHz data  */
-		{
-		    if (pars.mode & A_WEIGHT)  /* filtering with A-weighting curve */
-			AWeightFil(speech, no_speech_samples, 8000);
-		    else if (!(pars.mode & SNR_4khz))  /* If NOT full 4 kHz bandwidth --> G.712 filtering  */
-		  	filter_samples(speech, no_speech_samples, G712);
-		    init_speech_voltmeter(&volt_state, 8000.);
-		    if ( (pars.mode & DC_COMP) && (!(pars.mode & A_WEIGHT)) )
-			DCOffsetFil(speech, no_speech_samples, 8000);
-		    speech_level = speech_voltmeter(speech, no_speech_samples, &volt_state);
-		}
-		if (filename ==NULL)
-		{
-			fprintf(fp_log, " file:stdin  s-level:%6.2f  ", speech_level);
-		}
-		else
+		if ( (ret = fant_process(ctx, speech, no_speech_samples, &req, &res)) != FANT_OK)
 		{
-			fprintf(fp_log, " file:%s  s-level:%6.2f  ", &filename[i+1], speech_level);
+			fprintf(stderr, "\ncannot process speech file %s: %s\n", filename == NULL ? "stdin" : filename, fant_strerror(ret));
+			exit(-1);
 		}
 
+		write_result(&pars, fp_log, (filename == NULL) ? "stdin" : filename, &req, &res);
+
+		t1 = fant_time();
+		write_samples(speech, no_speech_samples, out_filename, ctx->plan.rate, pars.float32);
 		free(speech);
+		fclose(fp_speech);
+		FANT_TRACE("write", t1, fant_time());
+		FANT_TRACE("file", t0, fant_time());
+		res.time[FANT_T_READ] = t_read;
+		res.time[FANT_T_WRITE] = fant_time() - t1;
+		if (pars.stats != NULL)
+			fant_stats_add(pars.stats, &res, no_speech_samples, fant_time() - t0);
+		add_result(&pars, -1, (filename == NULL) ? "stdin" : filename,
+			(out_filename == NULL) ? "stdout" : out_filename, no_speech_samples, &req, &res, NULL, fant_time() - t0);
+}
 
-		/* load samples of speech signal again */
-		speech = speech_two_pass;
+/***  input list with read-ahead, outputs written behind or into an archive  ***/
+/*    returns the number of entries written to the failure report           */
+long process_list(PARAMETER *pars, FILE *fp_list, FILE *fp_outlist, FANT_MANIFEST *man,
+	FANT_CONTEXT *ctx, FILE *fp_index, FILE *fp_log)
+{
+	FANT_IO     *io;
+	FANT_ARC    *arc = NULL;
+	FANT_CACHE  *cache = NULL;
+	FANT_JOURNAL *jrn = NULL;
+	FANT_FEAT   *feat = NULL;
+	FANT_JOB    *jobs, *job;
+	FANT_REQUEST req;
+	FANT_RESULT  res;
+	FILE        *fp_fail = NULL;
+	char       (*filename)[300], (*out_filename)[300], *arc_name = NULL, error[300];
+	const char  *reason;
+	double       t0, t_read, t1;
+	short       *buf;
+	float       *sig = NULL;
+	long        *entry, *done, no_samples, no_jobs = 0, no_entries = 0, no_skipped = 0, no_failed = 0;
+	int          depth = (pars->prefetch > 0) ? pars->prefetch : 1;
+	int          no_queued = 0, next = 0, end_of_list = 0, missing_output = 0, no_shards = 0, ret, k;
 
-		/* filter speech signal */
-		if (pars.mode & FILTER)
-		{
-		    filter_samples(speech, no_speech_samples, pars.filter_type);
+	if ( ( (io = fant_io_init(pars->io_threads, depth)) == NULL) ||
+	     ( (jobs = calloc((size_t)depth, sizeof(FANT_JOB))) == NULL) ||
+	     ( (entry = calloc((size_t)depth, sizeof(long))) == NULL) ||
+	     ( (done = calloc((size_t)depth, sizeof(long))) == NULL) ||
+	     ( (filename = calloc((size_t)depth, sizeof(*filename))) == NULL) ||
+	     ( (out_filename = calloc((size_t)depth, sizeof(*out_filename))) == NULL) )
+	{
+		fprintf(stderr, "cannot start the background I/O!\n");
+		exit(-1);
+	}
+	if (pars->archive != NULL)
+	{
+		/* room for the shard number, whatever the length of the path */
+		if ( (arc_name = (char*)malloc(strlen(pars->archive) + 16)) == NULL)
+		{
+			fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+			exit(-1);
 		}
+		arc = open_archive(pars, no_shards++, arc_name);
+	}
+	if ( (pars->cache != NULL) && ( (cache = fant_cache_open(pars->cache)) == NULL) )
+	{
+		fprintf(stderr, "\ncannot open cache file %s\n\n", pars->cache);
+		exit(-1);
+	}
+	if ( (pars->journal != NULL) &&
+	     ( (jrn = fant_journal_open(pars->journal, pars->resume, error, sizeof(error))) == NULL) )
+	{
+		fprintf(stderr, "\ninvalid journal %s: %s\n\n", pars->journal, error);
+		exit(-1);
+	}
+	io->rate = ctx->plan.rate;
+	io->big_endian = pars->big_endian;
+	if ( (pars->failures != NULL) && ( (fp_fail = fopen(pars->failures, "w")) == NULL) )
+	{
+		fprintf(stderr, "\ncannot open failure report %s\n\n", pars->failures);
+		exit(-1);
+	}
+	if ( (pars->features != NULL) &&
+	     ( (feat = fant_feat_init(ctx->plan.rate, pars->feat_win, pars->feat_hop, pars->feat_bins)) == NULL) )
+	{
+		fprintf(stderr, "\ninvalid feature parameters %g,%g,%d\n\n", pars->feat_win, pars->feat_hop, pars->feat_bins);
+		exit(-1);
+	}
 
-		/* normalize level of speech signal to desired level  */
-		if (pars.mode & NORM)
+	for (;;)
+	{
+		/* keep "prefetch" speech files queued */
+		while (!end_of_list && (no_queued < depth))
 		{
-			factor = pow(10., (pars.norm_level - speech_level)/20.);
-			scale(speech, no_speech_samples, factor);
-			speech_level = pars.norm_level;
+			k = (next + no_queued) % depth;
+			if (man != NULL)
+			{
+				if (no_jobs == man->no_jobs)
+					end_of_list = 1;
+				else
+					jobs[k] = man->jobs[no_jobs++];
+			}
+			else
+			{
+				/* job from the lists with the conditions of the command line */
+				if ( fscanf(fp_list, "%s", filename[k]) == EOF)
+					end_of_list = 1;
+				else if ( fp_outlist == NULL)
+					strcpy(out_filename[k], filename[k]);
+				else if ( fscanf(fp_outlist, "%s", out_filename[k]) == EOF)
+					end_of_list = missing_output = 1;
+				jobs[k].input = filename[k];
+				jobs[k].output = out_filename[k];
+				jobs[k].noise_id = 0;
+				jobs[k].start = FANT_RANDOM;
+				jobs[k].snr = NONE;
+				jobs[k].filter_type = NONE;
+			}
+			if (end_of_list)
+				break;
+			entry[k] = no_entries++;
+			done[k] = (jrn != NULL) ? fant_journal_done(jrn, entry[k], jobs[k].output) : FANT_JOURNAL_NONE;
+			if (done[k] == FANT_JOURNAL_MISMATCH)
+			{
+				fprintf(stderr, "\njournal %s does not match entry %ld (%s)\n\n", pars->journal, entry[k], jobs[k].output);
+				exit(-1);
+			}
+			/* journaled entries are not read again */
+			if ( (done[k] == FANT_JOURNAL_NONE) && (fant_io_read(io, jobs[k].input) != FANT_OK) )
+			{
+				fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+				exit(-1);
+			}
+			no_queued++;
 		}
+		if (no_queued == 0)
+			break;
 
-		if (pars.mode & ADD)  /*  Noise adding  */
+		job = &jobs[next];
+		fant_default_request(&req);
+		req.noise_id = job->noise_id;
+		req.filter_type = job->filter_type;
+		req.keep_overload = pars->float32;
+		if (done[next] != FANT_JOURNAL_NONE)
+		{
+			/* draw as before the interruption */
+			if (draw_request(pars, ctx, done[next], fp_index, &req) != FANT_OK)
+			{
+				fprintf(stderr, "\nInsufficient number of indices defined in index list file!\n");
+				exit(-1);
+			}
+			if ( (pars->results != NULL) && (fant_results_skip(pars->results, entry[next]) != FANT_OK) )
+			{
+				fprintf(stderr, "\ncannot write results file %s\n\n", pars->results_file);
+				exit(-1);
+			}
+			no_skipped++;
+		}
+		else if ( (t0 = fant_time(), buf = fant_io_next(io, &no_samples, &ret)) == NULL)
 		{
-			if ( ( noise_buf = (float*)calloc((size_t)no_speech_samples, sizeof(float))) == NULL)
+			reason = (ret == FANT_ERR_IO) ? "cannot open speech file" : fant_strerror(ret);
+			if ( ( (ret != FANT_ERR_IO) && (ret != FANT_ERR_FORMAT) && (ret != FANT_ERR_RATE) ) || (fp_fail == NULL) )
 			{
-				fprintf(stderr, "cannot allocate enough memory to buffer noise samples!\n");
+				fant_io_flush(io);
+				if (ret == FANT_ERR_IO)
+					fprintf(stderr, "\ncannot open speech file %s\n", job->input);
+				else if ( (ret == FANT_ERR_FORMAT) || (ret == FANT_ERR_RATE) )
+					fprintf(stderr, "\nspeech file %s: %s\n", job->input, reason);
+				else
+					fprintf(stderr, "cannot reallocate enough memory to buffer samples!\n");
 				exit(-1);
 			}
-			if (no_noise_samples > no_speech_samples)  /* noise signal longer than speech signal */
+			report_failure(fp_fail, job, reason);
+			add_result(pars, entry[next], job->input, job->output, 0, &req, NULL,
+				reason, fant_time() - t0);
+			no_failed++;
+		}
+		else
+		{
+			/* conditions of the job replace the drawn ones, the random
+			   generator advances as for the other jobs                 */
+			t_read = fant_time() - t0;
+			fant_trace_file(job->input);
+			FANT_TRACE("wait_read", t0, t0 + t_read);
+			if (draw_request(pars, ctx, no_samples, fp_index, &req) != FANT_OK)
 			{
-				/* select segment randomly out of noise signal */
-				if (pars.mode & IND_LIST)
+				if (fp_fail == NULL)
 				{
-				   if ( fscanf(fp_index, "%ld", &start) == EOF)
-				   {
+					fant_io_flush(io);
 					fprintf(stderr, "\nInsufficient number of indices defined in index list file!\n");
 					exit(-1);
-				   }
-				}
-				else
-				   start = (long) ( (double)(rand())/(RAND_MAX) * (double)(no_noise_samples - no_speech_samples));
-
-				fprintf(fp_log, "1st noise sample:%ld  ", start);
-
-				/* calculate noise level of selected segment  */
-				if (pars.mode & SAMP16K)  /*  16 kHz data  */
-				{
-		    		    if (pars.mode & SNR_8khz)  /* calculate noise level from 16 kHz data  */
-		    		    {
-				  	memcpy(noise_buf, &noise_g712[start], (size_t)(no_speech_samples*sizeof(float)));
-					init_speech_voltmeter(&volt_state, 16000.);
-				  	speech_voltmeter(noise_buf, no_speech_samples, &volt_state);
-		    		    }
-		    		    else  /* calculate noise level from downsampled 8 kHz data  */
-		    		    {
-				  	memcpy(noise_buf, &noise_g712[start/2], (size_t)(no_speech_samples/2*sizeof(float)));
-					init_speech_voltmeter(&volt_state, 8000.);
-				  	speech_voltmeter(noise_buf, no_speech_samples/2, &volt_state);
-				    }
 				}
-				else  /*  8 kHz data  */
+				ret = FANT_ERR_PARAM;
+				reason = "insufficient number of indices in index list";
+			}
+			else
+			{
+				if (job->start != FANT_RANDOM)
+					req.start = job->start;
+				if (job->snr != NONE)
+					req.snr = job->snr;
+				if ( ( (pars->clean != NULL) || (pars->scaled_noise != NULL) ) &&
+				     ( (req.clean = (float*)calloc((size_t)no_samples+1, sizeof(float))) == NULL) )
 				{
-				   memcpy(noise_buf, &noise_g712[start], (size_t)(no_speech_samples*sizeof(float)));
-				   init_speech_voltmeter(&volt_state, 8000.);
-				   speech_voltmeter(noise_buf, no_speech_samples, &volt_state);
+					fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+					exit(-1);
 				}
-
-				noise_level = SVP56_get_rms_dB(volt_state);
-				fprintf(fp_log, "n-level:%6.2f", noise_level);
-				memcpy(noise_buf, &noise[start], (size_t)(no_speech_samples*sizeof(float)));
+				if (cache != NULL)
+					ret = process_cached(pars, ctx, cache, job->input, buf, no_samples, &req, &res,
+						pars->float32 ? &sig : NULL);
+				else if (pars->float32)
+					ret = process_float(ctx, buf, no_samples, &req, &res, &sig);
+				else
+					ret = fant_process_short(ctx, buf, buf, no_samples, &req, &res);
+				reason = fant_strerror(ret);
 			}
-			else /* speech signal longer than noise signal */
-			     /* use noise signal several times by starting with the 1st sample again at the end  */
+			if ( (ret != FANT_OK) && (fp_fail == NULL) )
 			{
-				no = 0;
-				if (pars.mode & SAMP16K)  /*  16 kHz data  */
+				fant_io_flush(io);
+				fprintf(stderr, "\ncannot process speech file %s: %s\n", job->input, fant_strerror(ret));
+				exit(-1);
+			}
+			else if (ret != FANT_OK)
+			{
+				report_failure(fp_fail, job, reason);
+				add_result(pars, entry[next], job->input, job->output, no_samples, &req, NULL,
+					reason, fant_time() - t0);
+				no_failed++;
+				free(buf);
+				free(req.clean);
+			}
+			else
+			{
+				write_result(pars, fp_log, job->input, &req, &res);
+				t1 = fant_time();
+				if (req.clean != NULL)
+					write_triplet(pars, io, job->output, buf, no_samples, &req,
+						( (jrn != NULL) || (fp_fail != NULL) ) ? entry[next] : -1, fp_log);
+				if (feat != NULL)
+					write_features(pars, feat, job->output, buf, no_samples);
+				if (pars->features_only)
+					free(buf);
+				else if (pars->float32)
 				{
-				  if (pars.mode & SNR_8khz)  /* FULL 8 kHz bandwidth  */
-				  {
-				     while (no < no_speech_samples)
-				     {
-					if ((no_speech_samples-no) > no_noise_samples)
-					{
-						memcpy(&noise_buf[no], noise_g712,(size_t)(no_noise_samples*sizeof(float)));
-						no += no_noise_samples;
-					}
-					else
-					{
-						memcpy(&noise_buf[no], noise_g712,(size_t)((no_speech_samples-no)*sizeof(float)));
-						no = no_speech_samples;
-					}
-				     }
-				     init_speech_voltmeter(&volt_state, 16000.);
-				     speech_voltmeter(noise_buf, no_speech_samples, &volt_state);
-				  }
-				  else  /* in case of 4 kHz bandwidth with or without G.712 filtering  */
-				        /* process downsampled version of noise signal */
-				  {
-				    while (no < no_speech_samples/2)
-				    {
-					if ((no_speech_samples/2-no) > no_noise_samples/2)
-					{
-						memcpy(&noise_buf[no], noise_g712,(size_t)(no_noise_samples/2*sizeof(float)));
-						no += no_noise_samples/2;
-					}
-					else
+					free(buf);
+					if (fant_io_write_float(io, job->output, sig, no_samples,
+						( (jrn != NULL) || (fp_fail != NULL) ) ? entry[next] : -1) != FANT_OK)
 					{
-						memcpy(&noise_buf[no], noise_g712,(size_t)((no_speech_samples/2-no)*sizeof(float)));
-						no = no_speech_samples/2;
+						fprintf(stderr, "\ncannot write output file %s\n\n", fant_io_failed(io));
+						exit(-1);
 					}
-				    }
-				    init_speech_voltmeter(&volt_state, 8000.);
-				    speech_voltmeter(noise_buf, no_speech_samples/2, &volt_state);
-				  }
 				}
-				else  /*  8 kHz data  */
+				else if (arc != NULL)
 				{
-				  while (no < no_speech_samples)
-				  {
-					if ((no_speech_samples-no) > no_noise_samples)
+					if ( (pars->shard_size > 0) && (arc->no_entries == pars->shard_size) )
 					{
-						memcpy(&noise_buf[no], noise_g712,(size_t)(no_noise_samples*sizeof(float)));
-						no += no_noise_samples;
+						if (fant_arc_close(arc) != FANT_OK)
+						{
+							fprintf(stderr, "could not write all samples to archive %s!\n", arc_name);
+							exit(-1);
+						}
+						arc = open_archive(pars, no_shards++, arc_name);
 					}
-					else
+					if (fant_arc_append(arc, job->output, buf, no_samples, &res) != FANT_OK)
 					{
-						memcpy(&noise_buf[no], noise_g712,(size_t)((no_speech_samples-no)*sizeof(float)));
-						no = no_speech_samples;
+						fprintf(stderr, "could not write all samples to archive %s!\n", arc_name);
+						exit(-1);
 					}
-				  }
-				  init_speech_voltmeter(&volt_state, 8000.);
-				  speech_voltmeter(noise_buf, no_speech_samples, &volt_state);
+					free(buf);
 				}
-
-				noise_level = SVP56_get_rms_dB(volt_state);
-				fprintf(fp_log, "noise too short! n-level:%6.2f", noise_level);
-				no = 0;
-				while (no < no_speech_samples)
+				else if (fant_io_write_tag(io, job->output, buf, no_samples,
+					( (jrn != NULL) || (fp_fail != NULL) ) ? entry[next] : -1) != FANT_OK)
 				{
-					if ((no_speech_samples-no) > no_noise_samples)
-					{
-						memcpy(&noise_buf[no], noise, (size_t)(no_noise_samples*sizeof(float)));
-						no += no_noise_samples;
-					}
-					else
-					{
-						memcpy(&noise_buf[no], noise, (size_t)((no_speech_samples-no)*sizeof(float)));
-						no = no_speech_samples;
-					}
+					fprintf(stderr, "\ncannot write output file %s\n\n", fant_io_failed(io));
+					exit(-1);
 				}
+				FANT_TRACE((arc != NULL) ? "archive" : "queue_write", t1, fant_time());
+				FANT_TRACE("file", t0, fant_time());
+				res.time[FANT_T_READ] = t_read;
+				res.time[FANT_T_WRITE] = fant_time() - t1;
+				if (pars->stats != NULL)
+					fant_stats_add(pars->stats, &res, no_samples, fant_time() - t0);
+				add_result(pars, entry[next], job->input, job->output, no_samples, &req, &res,
+					NULL, fant_time() - t0);
 			}
-			if (pars.mode & SNRANGE)
-			{ 
-			  snr = (double)pars.snr + ( (double)(rand())/(double)(RAND_MAX) * (double)(pars.snr_range) );	
-			  fprintf(fp_log, "  SNR:%f", snr);
+		}
+		no_failed += track_outputs(pars, io, jrn, fp_fail);
+		next = (next + 1) % depth;
+		no_queued--;
+	}
+
+	if (fant_io_flush(io) != FANT_OK)
+	{
+		fprintf(stderr, "\ncannot write output file %s\n\n", fant_io_failed(io));
+		exit(-1);
+	}
+	no_failed += track_outputs(pars, io, jrn, fp_fail);
+	if ( (arc != NULL) && (fant_arc_close(arc) != FANT_OK) )
+	{
+		fprintf(stderr, "could not write all samples to archive %s!\n", arc_name);
+		exit(-1);
+	}
+	free(arc_name);
+	if (cache != NULL)
+	{
+		fprintf(fp_log, "analysis cache %s: %ld hits, %ld misses\n", pars->cache, cache->no_hits, cache->no_misses);
+		if (fant_cache_close(cache) != FANT_OK)
+		{
+			fprintf(stderr, "\ncannot write cache file %s\n\n", pars->cache);
+			exit(-1);
+		}
+	}
+	if (jrn != NULL)
+	{
+		if (no_skipped > 0)
+			fprintf(fp_log, "journal %s: %ld files skipped\n", pars->journal, no_skipped);
+		if (fant_journal_close(jrn) != FANT_OK)
+		{
+			fprintf(stderr, "\ncannot write journal %s\n\n", pars->journal);
+			exit(-1);
+		}
+	}
+	if (fp_fail != NULL)
+	{
+		if (no_failed > 0)
+			fprintf(fp_log, "%ld files failed, see %s\n", no_failed, pars->failures);
+		fclose(fp_fail);
+	}
+	if (missing_output)
+	{
+		fprintf(stderr, "\nInsufficient number of files defined in output list!\n");
+		exit(-1);
+	}
+	fant_io_free(io);
+	fant_feat_free(feat);
+	free(jobs);
+	free(entry);
+	free(done);
+	free(filename);
+	free(out_filename);
+	return no_failed;
+}
+
+/***  journal the entries with all outputs written, report the failed ones  ***/
+long track_outputs(PARAMETER *pars, FANT_IO *io, FANT_JOURNAL *jrn, FILE *fp_fail)
+{
+	FANT_IO_JOB *written;
+	FANT_JOB     job;
+	long         no_failed = 0;
+
+	while ( (written = fant_io_written(io)) != NULL)
+	{
+		if (written->status != FANT_OK)
+		{
+			memset(&job, 0, sizeof(job));
+			job.output = written->name;
+			if (fp_fail == NULL)
+			{
+				fprintf(stderr, "\ncannot write output file %s\n\n", written->name);
+				exit(-1);
 			}
-			else
-			  snr = pars.snr;
-			factor = pow(10., ((speech_level - snr) - noise_level)/20.);
-			scale(noise_buf, no_speech_samples, factor);
-			/*fmax = 0.; */
-			for (i=0; i<no_speech_samples; i++)
+			report_failure(fp_fail, &job, "cannot write output file");
+			no_failed++;
+		}
+		else if ( (jrn != NULL) && (fant_journal_add(jrn, written->tag, written->no_samples, written->name) != FANT_OK) )
+		{
+			fprintf(stderr, "\ncannot write journal %s\n\n", pars->journal);
+			exit(-1);
+		}
+		fant_io_release(written);
+	}
+	return no_failed;
+}
+
+/***  input <TAB> output <TAB> reason  ***/
+void report_failure(FILE *fp_fail, FANT_JOB *job, const char *reason)
+{
+	fprintf(fp_fail, "%s\t%s\t%s\n", (job->input != NULL) ? job->input : "-", job->output, reason);
+	fflush(fp_fail);
+}
+
+/***  fant_process_short() with the speech level (and the filtered speech)  ***/
+/*    of an unchanged speech file taken from the cache (out != NULL: the   */
+/*    float output as process_float())                                     */
+int process_cached(PARAMETER *pars, FANT_CONTEXT *ctx, FANT_CACHE *cache, char *name,
+	short *buf, long no_samples, FANT_REQUEST *req, FANT_RESULT *res, float **out)
+{
+	FANT_CACHE_ENTRY *entry;
+	float            *speech;
+	double            level, activity = NONE, t0, t_convert;
+	int               filter_type, mode, ret;
+
+	filter_type = (req->filter_type != NONE) ? req->filter_type : ctx->plan.filter_type;
+	if (!pars->cache_filtered)
+		filter_type = NONE;
+	mode = pars->mode | (pars->big_endian ? FANT_CACHE_BIG_ENDIAN : 0);
+	if ( ( speech = (float*)calloc((size_t)no_samples+1, sizeof(float))) == NULL)
+		return FANT_ERR_MEMORY;
+	t0 = fant_time();
+	FANT_PERF_CALL(FANT_K_SH2FL, no_samples, fant_kernels.sh2fl(no_samples, buf, speech));
+	t_convert = fant_time() - t0;
+
+	if ( (entry = fant_cache_find(cache, name, mode, filter_type)) != NULL)
+	{
+		req->speech_level = entry->rec.speech_level;
+		activity = entry->rec.activity;
+		if ( (filter_type != NONE) && (entry->rec.no_samples == no_samples) &&
+		     (fant_cache_samples(cache, entry, speech) == FANT_OK) )
+			req->prefiltered = 1;
+		else if (filter_type != NONE)
+		{
+			/* no valid samples, the level alone is used */
+			FANT_PERF_CALL(FANT_K_SH2FL, no_samples, fant_kernels.sh2fl(no_samples, buf, speech));
+		}
+	}
+	else if (filter_type != NONE)
+	{
+		/* the filtered speech is stored before the noise is added */
+		if ( ( (ret = fant_speech_level(ctx, speech, no_samples, &level, &activity)) != FANT_OK) ||
+		     ( (ret = filter_samples(speech, no_samples, filter_type)) != FANT_OK) )
+		{
+			free(speech);
+			return ret;
+		}
+		if ( (ret = fant_cache_add(cache, name, mode, filter_type, level, activity, speech, no_samples)) != FANT_OK)
+			fprintf(stderr, "\ncannot add %s to cache %s: %s\n", name, pars->cache, fant_strerror(ret));
+		req->speech_level = level;
+		req->prefiltered = 1;
+	}
+
+	if ( (ret = fant_process(ctx, speech, no_samples, req, res)) == FANT_OK)
+	{
+		/* the level from the cache: its activity factor as measured */
+		if (activity != NONE)
+			res->activity = activity;
+		t0 = fant_time();
+		if (out == NULL)
+			FANT_PERF_CALL(FANT_K_FL2SH, no_samples, fant_kernels.fl2sh(no_samples, speech, buf));
+		res->time[FANT_T_CONVERT] = t_convert + fant_time() - t0;
+		if ( (entry == NULL) && (filter_type == NONE) &&
+		     ( (ret = fant_cache_add(cache, name, mode, NONE, res->speech_level, res->activity, NULL, 0)) != FANT_OK) )
+		{
+			fprintf(stderr, "\ncannot add %s to cache %s: %s\n", name, pars->cache, fant_strerror(ret));
+			ret = FANT_OK;  /* the output is valid */
+		}
+	}
+	if ( (ret == FANT_OK) && (out != NULL) )  /* float32 output */
+		*out = speech;
+	else
+		free(speech);
+	return ret;
+}
+
+/***  as fant_process_short(), the output is kept as float (--format float32)  ***/
+int process_float(FANT_CONTEXT *ctx, short *buf, long no_samples, FANT_REQUEST *req,
+	FANT_RESULT *res, float **out)
+{
+	float *speech;
+	int    ret;
+	double t0, t_convert;
+
+	if ( ( speech = (float*)calloc((size_t)no_samples+1, sizeof(float))) == NULL)
+		return FANT_ERR_MEMORY;
+	t0 = fant_time();
+	FANT_PERF_CALL(FANT_K_SH2FL, no_samples, fant_kernels.sh2fl(no_samples, buf, speech));
+	t_convert = fant_time() - t0;
+	FANT_TRACE("convert", t0, t0 + t_convert);
+	if ( (ret = fant_process(ctx, speech, no_samples, req, res)) != FANT_OK)
+	{
+		free(speech);
+		return ret;
+	}
+	res->time[FANT_T_CONVERT] = t_convert;
+	*out = speech;
+	return FANT_OK;
+}
+
+/***  read the manifest and complete the processing mode  ***/
+FANT_MANIFEST *read_manifest(PARAMETER *pars)
+{
+	FANT_MANIFEST *man;
+	FANT_JOB      *job;
+	char           error[300];
+	long           i;
+	int            filters = 0;
+
+	if ( (man = fant_read_manifest(pars->manifest, error, sizeof(error))) == NULL)
+	{
+		fprintf(stderr, "\ninvalid manifest %s: %s\n\n", pars->manifest, error);
+		exit(-1);
+	}
+	for (i=0 ; i<man->no_jobs ; i++)
+	{
+		job = &man->jobs[i];
+		if ( (job->noise != NULL) && (strcmp(job->noise, FANT_JOB_NO_NOISE) != 0) )
+			pars->mode = pars->mode | ADD;
+		if (job->filter_type == NONE)
+			continue;
+		filters = 1;
+		if (pars->mode & SAMP16K)
+		{
+			if (job->filter_type != P341)
 			{
-				speech[i] += noise_buf[i];
-				/*if (fabs((double)speech[i]) > fmax)
-					fmax = fabs((double)speech[i]);*/
+				fprintf(stderr, "\nmanifest %s, line %ld: Processing of 16 kHz data can not be combined with G.712, IRS or MIRS filtering right now!\n\n",
+					pars->manifest, job->line);
+				exit(-1);
 			}
-			/*if (fmax > 1.)
+			job->filter_type = P341_16K;
+		}
+		else if (pars->mode & SAMP32K)
+		{
+			fprintf(stderr, "\nmanifest %s, line %ld: Processing of 32 kHz data can not be combined with filtering right now!\n\n",
+				pars->manifest, job->line);
+			exit(-1);
+		}
+		else if (pars->mode & SAMP48K)
+		{
+			if (job->filter_type != MIRS)
 			{
-				fprintf(fp_log, "\n ATTENTION!!! overload: %6.2f", fmax);
-				for (i=0; i<no_speech_samples; i++)
-					speech[i] /= (float)fmax;
-			} */
-			
-			free(noise_buf);
+				fprintf(stderr, "\nmanifest %s, line %ld: Processing of 48 kHz data can only be combined with MIRS filtering right now!\n\n",
+					pars->manifest, job->line);
+				exit(-1);
+			}
+			job->filter_type = MIRS_48K;
+		}
+	}
+	for (i=0 ; i<man->no_jobs ; i++)
+	{
+		job = &man->jobs[i];
+		if ( (pars->mode & ADD) && (job->snr == NONE) && (pars->snr == NONE) &&
+		     ( (job->noise == NULL) ? (pars->noise_file != NULL) : (strcmp(job->noise, FANT_JOB_NO_NOISE) != 0) ) )
+		{
+			fprintf(stderr, "\nmanifest %s, line %ld: SNR not defined for noise adding\n\n", pars->manifest, job->line);
+			exit(-1);
 		}
-		/* The overload check has been moved here!
-		   Now the check is also done in case of a level normalization only! */
-		fmax = 0.;
-		for (i=0; i<no_speech_samples; i++)
+	}
+	if ( !(pars->mode & (ADD | FILTER | NORM)) && !filters)
+	{
+		fprintf(stderr, "\n\n Either noise adding nor filtering nor normalization defined!\n\n");
+		exit(-1);
+	}
+	return man;
+}
+
+/***  noise of the command line (id 0) and all noises of the manifest  ***/
+void load_noises(PARAMETER *pars, FANT_MANIFEST *man, FANT_CONTEXT *ctx, FILE *fp_log)
+{
+	FANT_JOB **sorted;
+	long       i;
+	int        id = FANT_NO_NOISE, default_id = FANT_NO_NOISE;
+
+	if (pars->noise_file != NULL)
+		default_id = load_noise(ctx, pars->noise_file, pars->noise_rate, pars->big_endian, fp_log);
+	if (man == NULL)
+		return;
+
+	/* each noise file is loaded once */
+	if ( (sorted = (FANT_JOB**)calloc((size_t)man->no_jobs+1, sizeof(FANT_JOB*))) == NULL)
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+	for (i=0 ; i<man->no_jobs ; i++)
+		sorted[i] = &man->jobs[i];
+	qsort(sorted, (size_t)man->no_jobs, sizeof(FANT_JOB*), compare_noises);
+	for (i=0 ; i<man->no_jobs ; i++)
+	{
+		if (sorted[i]->noise == NULL)
+			sorted[i]->noise_id = default_id;
+		else if (strcmp(sorted[i]->noise, FANT_JOB_NO_NOISE) == 0)
+			sorted[i]->noise_id = FANT_NO_NOISE;
+		else
+		{
+			if ( (i == 0) || (sorted[i-1]->noise == NULL) || (strcmp(sorted[i-1]->noise, sorted[i]->noise) != 0) )
+				id = load_noise(ctx, sorted[i]->noise, pars->noise_rate, pars->big_endian, fp_log);
+			sorted[i]->noise_id = id;
+		}
+	}
+	free(sorted);
+}
+
+int compare_noises(const void *a, const void *b)
+{
+	char *na = (*(FANT_JOB**)a)->noise, *nb = (*(FANT_JOB**)b)->noise;
+
+	if ( (na == NULL) || (nb == NULL) )
+		return (na != NULL) - (nb != NULL);
+	return strcmp(na, nb);
+}
+
+/***  load samples of noise signal and filter it once
+      for calculating noise level N and for the output  ***/
+/***  noise_rate: of raw files, 0 for the rate of the speech; big_endian: raw files are big endian  ***/
+int load_noise(FANT_CONTEXT *ctx, char *name, int noise_rate, int big_endian, FILE *fp_log)
+{
+	FILE  *fp_noise;
+	float *noise;
+	long   no_noise_samples;
+	int    ret, file_rate = (noise_rate > 0) ? noise_rate : ctx->plan.rate;
+	double t0 = fant_time();
+
+	fant_trace_file(name);
+	if ( (fp_noise = fopen(name, "r")) == NULL)
+	{
+		fprintf(stderr, "\ncannot open noise file %s\n\n", name);
+		exit(-1);
+	}
+	noise = load_samples(fp_noise, &no_noise_samples, ctx->plan.rate, &file_rate, big_endian, name);
+	fprintf(fp_log, " %ld noise samples loaded from %s\n", no_noise_samples, name);
+	if (file_rate != ctx->plan.rate)
+		fprintf(fp_log, " Noise signal resampled from %d Hz to %d Hz\n", file_rate, ctx->plan.rate);
+	fclose(fp_noise);
+	FANT_TRACE("load_noise", t0, fant_time());
+	if ( (ret = fant_add_noise(ctx, noise, no_noise_samples)) < 0)
+	{
+		fprintf(stderr, "\ncannot prepare noise file %s: %s\n\n", name, fant_strerror(ret));
+		exit(-1);
+	}
+	free(noise);
+	if (ctx->pars.mode & FILTER)
+		fprintf(fp_log, " Noise signal filtered\n");
+	return ret;
+}
+
+/***  name: strlen(pars->archive)+16 bytes  ***/
+FANT_ARC *open_archive(PARAMETER *pars, int shard, char *name)
+{
+	FANT_ARC *arc;
+
+	if (pars->shard_size > 0)
+		sprintf(name, "%s.%d", pars->archive, shard);
+	else
+		strcpy(name, pars->archive);
+	if ( (arc = fant_arc_create(name)) == NULL)
+	{
+		fprintf(stderr, "\ncannot open output archive %s\n\n", name);
+		exit(-1);
+	}
+	return arc;
+}
+
+/***  framed utterances from stdin to stdout  ***/
+void process_stream(PARAMETER *pars, FANT_CONTEXT *ctx, FILE *fp_index, FILE *fp_log)
+{
+	FANT_FRAME_IN  in;
+	FANT_FRAME_OUT out;
+	FANT_REQUEST   req;
+	FANT_RESULT    res;
+	short         *buf = NULL;
+	long           no_frames, max_samples = 0;
+	char           name[32];
+	double         t0, t_read, t1;
+
+	for (no_frames=0 ; (t0 = fant_time(), fread(&in, sizeof(in), 1, stdin)) == 1 ; no_frames++)
+	{
+		if ( (memcmp(in.magic, FANT_FRAME_IN_MAGIC, 4) != 0) || (in.no_samples < 0) )
 		{
-			if (fabs((double)speech[i]) > fmax)
-				fmax = fabs((double)speech[i]);  
+			fprintf(stderr, "\ninvalid header of frame %ld in stream\n", no_frames);
+			exit(-1);
 		}
-		if (fmax > 1.)
+		if (in.no_samples > max_samples)
 		{
-			fprintf(fp_log, "\n ATTENTION!!! overload by factor %6.2f", fmax);
-			for (i=0; i<no_speech_samples; i++)
-				speech[i] /= (float)fmax;
-			if (pars.mode & NORM)
+			free(buf);
+			max_samples = in.no_samples;
+			if ( ( buf = (short*)calloc((size_t)max_samples, sizeof(short))) == NULL)
 			{
-				// fprintf(stdout, "ATTENTION !!!\n" );
-				// fprintf(stdout, " Due to overload the speech level could only be normalized to %6.2f\n", pars.norm_level - 20*log10(fmax));
-				fprintf(fp_log, "\n Due to overload the speech level could only be normalized to %6.2f", pars.norm_level - 20*log10(fmax));
+				fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+				exit(-1);
 			}
-		} 
-		
-		write_samples(speech, no_speech_samples, out_filename);
-		free(speech);
-		fclose(fp_speech);
-		fprintf(fp_log, "\n");
-}
\ No newline at end of file
+		}
+		if (fread(buf, sizeof(short), (size_t)in.no_samples, stdin) != (size_t)in.no_samples)
+		{
+			fprintf(stderr, "\nincomplete samples of frame %ld in stream\n", no_frames);
+			exit(-1);
+		}
+		t_read = fant_time() - t0;
+		sprintf(name, "stdin#%ld", no_frames);
+		fant_trace_file(name);
+		FANT_TRACE("read", t0, t0 + t_read);
+
+		/* the flags of the frame replace the drawn conditions, the random
+		   generator advances as for the other frames (a seed draws the
+		   segment and the SNR of its frame in the library)             */
+		fant_default_request(&req);
+		if (draw_request(pars, ctx, in.no_samples, fp_index, &req) != FANT_OK)
+		{
+			fprintf(stderr, "\nInsufficient number of indices defined in index list file!\n");
+			exit(-1);
+		}
+		if (in.flags & FANT_FRAME_SEED)
+		{
+			req.seed = (unsigned int) in.seed;
+			req.start = FANT_RANDOM;
+			req.snr = NONE;
+		}
+		if (in.flags & FANT_FRAME_START)
+			req.start = in.start;
+		if (in.flags & FANT_FRAME_SNR)
+			req.snr = in.snr;
+
+		memset(&out, 0, sizeof(out));
+		memcpy(out.magic, FANT_FRAME_OUT_MAGIC, 4);
+		out.status = fant_process_short(ctx, buf, buf, in.no_samples, &req, &res);
+		if (out.status == FANT_OK)
+		{
+			out.no_samples = in.no_samples;
+			out.speech_level = res.speech_level;
+			out.noise_level = res.noise_level;
+			out.start = res.noise_short ? -1 : res.start;
+			out.snr = res.snr;
+			out.overload = res.overload;
+			sprintf(name, "stdin#%ld", no_frames);
+			write_result(pars, fp_log, name, &req, &res);
+		}
+		else
+			fprintf(fp_log, " file:stdin#%ld  %s\n", no_frames, fant_strerror(out.status));
+		t1 = fant_time();
+		if ( (fwrite(&out, sizeof(out), 1, stdout) != 1) ||
+		     (fwrite(buf, sizeof(short), (size_t)out.no_samples, stdout) != (size_t)out.no_samples) )
+		{
+			fprintf(stderr, "could not write all samples to stdout!\n");
+			exit(-1);
+		}
+		FANT_TRACE("write", t1, fant_time());
+		FANT_TRACE("file", t0, fant_time());
+		res.time[FANT_T_READ] = t_read;
+		res.time[FANT_T_WRITE] = fant_time() - t1;
+		if ( (pars->stats != NULL) && (out.status == FANT_OK) )
+			fant_stats_add(pars->stats, &res, in.no_samples, fant_time() - t0);
+		sprintf(name, "stdin#%ld", no_frames);
+		add_result(pars, no_frames, name, "stdout", in.no_samples, &req, &res,
+			(out.status == FANT_OK) ? NULL : fant_strerror(out.status), fant_time() - t0);
+	}
+	fflush(stdout);
+	free(buf);
+}
+
+/* The segment of the noise signal and the SNR are drawn here and not
+   in the library to keep the sequence of the random generator (-r).  */
+/***  FANT_ERR_PARAM if the index list is too short  ***/
+int draw_request(PARAMETER *pars, FANT_CONTEXT *ctx, long no_speech_samples,
+	FILE *fp_index, FANT_REQUEST *req)
+{
+	if ( !ctx->plan.add || (req->noise_id == FANT_NO_NOISE) )
+		return FANT_OK;
+	if (ctx->noises[req->noise_id].no_samples > no_speech_samples)  /* noise signal longer than speech signal */
+	{
+		/* select segment randomly out of noise signal */
+		if (pars->mode & IND_LIST)
+		{
+		   if ( fscanf(fp_index, "%ld", &req->start) == EOF)
+			return FANT_ERR_PARAM;
+		}
+		else
+		   req->start = (long) ( (double)(rand())/(RAND_MAX) * (double)(ctx->noises[req->noise_id].no_samples - no_speech_samples));
+	}
+	if (ctx->plan.snr_range)
+	  req->snr = (double)ctx->plan.snr + ( (double)(rand())/(double)(RAND_MAX) * (double)(ctx->plan.snr_width) );
+	else
+	  req->snr = ctx->plan.snr;
+	return FANT_OK;
+}
+
+/***  clean speech and scaled noise of an output (--clean, --scaled-noise)  ***/
+/*    The noise is written as the difference of the output and the clean    */
+/*    speech in 16 bit, so that the files add up to the output exactly; its  */
+/*    samples clipped to 16 bit are reported in the log. Both files are      */
+/*    tracked under the "tag" of the output.                                 */
+void write_triplet(PARAMETER *pars, FANT_IO *io, const char *output, short *noisy,
+	long no_samples, FANT_REQUEST *req, long tag, FILE *fp_log)
+{
+	char  *name;
+	short *clean, *noise;
+	long   i, d, no_clipped = 0;
+
+	if ( ( (clean = (short*)calloc((size_t)no_samples+1, sizeof(short))) == NULL) ||
+	     ( (noise = (short*)calloc((size_t)no_samples+1, sizeof(short))) == NULL) )
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+	FANT_PERF_CALL(FANT_K_FL2SH, no_samples, fant_kernels.fl2sh(no_samples, req->clean, clean));
+	for (i=0 ; i<no_samples ; i++)
+	{
+		d = (long)noisy[i] - (long)clean[i];
+		if ( (d > 32767) || (d < -32768) )
+			no_clipped++;
+		noise[i] = (short)( (d > 32767) ? 32767 : (d < -32768) ? -32768 : d );
+	}
+	if ( (no_clipped > 0) && (pars->scaled_noise != NULL) )
+		fprintf(fp_log, " ATTENTION!!! scaled noise of %s clipped at %ld samples (clean + noise != output)\n",
+			output, no_clipped);
+	free(req->clean);
+	req->clean = NULL;
+	if (pars->scaled_noise == NULL)
+		free(noise);
+	else
+	{
+		name = template_name(pars->scaled_noise, output);
+		if (fant_io_write_tag(io, name, noise, no_samples, tag) != FANT_OK)
+		{
+			fprintf(stderr, "\ncannot write output file %s\n\n", fant_io_failed(io));
+			exit(-1);
+		}
+		free(name);
+	}
+	if (pars->clean == NULL)
+		free(clean);
+	else
+	{
+		name = template_name(pars->clean, output);
+		if (fant_io_write_tag(io, name, clean, no_samples, tag) != FANT_OK)
+		{
+			fprintf(stderr, "\ncannot write output file %s\n\n", fant_io_failed(io));
+			exit(-1);
+		}
+		free(name);
+	}
+}
+
+/***  log-mel features of an output (--features), from the 16 bit  ***/
+/*    samples as they are written                                    */
+void write_features(PARAMETER *pars, FANT_FEAT *feat, const char *output, short *buf, long no_samples)
+{
+	char  *name;
+	float *sig, *out;
+	long   no_frames;
+
+	if ( ( (sig = (float*)calloc((size_t)no_samples+1, sizeof(float))) == NULL) ||
+	     ( (out = (float*)calloc((size_t)fant_feat_frames(feat, no_samples)*feat->no_bins+1, sizeof(float))) == NULL) )
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+	FANT_PERF_CALL(FANT_K_SH2FL, no_samples, fant_kernels.sh2fl(no_samples, buf, sig));
+	no_frames = fant_feat_compute(feat, sig, no_samples, out);
+	name = template_name(pars->features, output);
+	if (fant_feat_write(feat, name, out, no_frames) != FANT_OK)
+	{
+		fprintf(stderr, "\ncannot write feature file %s\n\n", name);
+		exit(-1);
+	}
+	free(name);
+	free(sig);
+	free(out);
+}
+
+/***  name of a template with a single %s for an output  ***/
+char *template_name(const char *templ, const char *output)
+{
+	char *name;
+
+	if ( (name = (char*)malloc(strlen(templ) + strlen(output) + 1)) == NULL)
+	{
+		fprintf(stderr, "cannot allocate enough memory to buffer samples!\n");
+		exit(-1);
+	}
+	sprintf(name, templ, output);
+	return name;
+}
+
+/***  a name template with a single %s  ***/
+int valid_template(const char *templ)
+{
+	const char *p = strchr(templ, '%');
+
+	return (p != NULL) && (p[1] == 's') && (strchr(p+1, '%') == NULL);
+}
+
+void write_result(PARAMETER *pars, FILE *fp_log, char *name, FANT_REQUEST *req, FANT_RESULT *res)
+{
+	fprintf(fp_log, " file:%s  s-level:%6.2f  ", name, res->speech_level);
+	if ( (pars->mode & ADD) && (req->noise_id != FANT_NO_NOISE) )
+	{
+		if (res->noise_short)
+			fprintf(fp_log, "noise too short! n-level:%6.2f", res->noise_level);
+		else
+			fprintf(fp_log, "1st noise sample:%ld  n-level:%6.2f", res->start, res->noise_level);
+		if ( (pars->mode & SNRANGE) || (pars->manifest != NULL) )
+			fprintf(fp_log, "  SNR:%f", res->snr);
+	}
+	if (res->overload > 1.)
+	{
+		fprintf(fp_log, "\n ATTENTION!!! overload by factor %6.2f", res->overload);
+		if (pars->float32)
+			fprintf(fp_log, " (kept in the float32 output)");
+		else if (pars->mode & NORM)
+		{
+			fprintf(fp_log, "\n Due to overload the speech level could only be normalized to %6.2f", pars->norm_level - 20*log10(res->overload));
+		}
+	}
+	fprintf(fp_log, "\n");
+}
+
+/***  record of a processed (error NULL) or failed file for --results  ***/
+/*    (entry -1 for the next entry)                                      */
+void add_result(PARAMETER *pars, long entry, const char *input, const char *output,
+	long no_samples, FANT_REQUEST *req, FANT_RESULT *res, const char *error, double wall)
+{
+	FANT_RESULT_RECORD rec;
+
+	if (pars->results == NULL)
+		return;
+	rec.input = input;
+	rec.output = output;
+	rec.error = error;
+	rec.no_samples = no_samples;
+	rec.noise = (pars->mode & ADD) && (req->noise_id != FANT_NO_NOISE);
+	rec.res = (error == NULL) ? res : NULL;
+	rec.wall = wall;
+	if (fant_results_add(pars->results, (entry < 0) ? pars->results->next : entry, &rec) != FANT_OK)
+	{
+		fprintf(stderr, "\ncannot write results file %s\n\n", pars->results_file);
+		exit(-1);
+	}
+}
+
+/***  sampling rate of the data (-u, --rate)  ***/
+int sample_rate(int mode)
+{
+	if (mode & SAMP48K)
+		return 48000;
+	if (mode & SAMP32K)
+		return 32000;
+	return (mode & SAMP16K) ? 16000 : 8000;
+}
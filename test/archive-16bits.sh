@@ -0,0 +1,6 @@
+set -e
+
+./filter_add_noise -i example/in.list -n example/subway.raw -u -s 10 -r 2000 -e fant.log --archive output.fnta
+./fant_archive list output.fnta
+./fant_archive extract output.fnta example/57353.raw output.raw
+cmp output.raw test/16bits.raw
@@ -0,0 +1,36 @@
+set -e
+
+# 2nd run takes the speech level from the cache
+rm -f output.cache
+printf 'example/57353.raw\toutput.raw\n' > output.tsv
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --cache output.cache --results output.csv
+cmp output.raw test/16bits.raw
+cut -d, -f1-11 output.csv > output.txt
+rm output.raw
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --cache output.cache --results output.csv
+cmp output.raw test/16bits.raw
+grep "output.cache: 1 hits" fant.log
+# the same results record (levels, activity, SNR) from the cache
+cut -d, -f1-11 output.csv | cmp - output.txt
+# the same file under another path is the same entry
+printf './example/../example/57353.raw\toutput.raw\n' > output.tsv
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --cache output.cache
+cmp output.raw test/16bits.raw
+grep "output.cache:" fant.log | tail -n 1 | grep -q "1 hits, 0 misses"
+test "$(grep -c 57353.raw output.cache)" -eq 1
+# also with the filtered speech in the cache
+rm -f output.cache
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -f p341 -s 10 -r 2000 -e fant.log --cache output.cache --cache-filtered --results output.csv
+cut -d, -f1-11 output.csv > output.txt
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -f p341 -s 10 -r 2000 -e fant.log --cache output.cache --cache-filtered --results output.csv
+grep "output.cache:" fant.log | tail -n 1 | grep -q "1 hits, 0 misses"
+cut -d, -f1-11 output.csv | cmp - output.txt
+# read as big endian the same file is another entry
+printf 'example/57353.raw\toutput.raw\n' > output.tsv
+./filter_add_noise --manifest output.tsv --big-endian -n example/subway.raw -u -s 10 -r 2000 -e fant.log
+mv output.raw output2.raw
+rm -f output.cache
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --cache output.cache
+./filter_add_noise --manifest output.tsv --big-endian -n example/subway.raw -u -s 10 -r 2000 -e fant.log --cache output.cache
+grep "output.cache:" fant.log | tail -n 1 | grep -q "0 hits, 1 misses"
+cmp output.raw output2.raw
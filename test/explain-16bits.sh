@@ -0,0 +1,10 @@
+set -e
+
+./filter_add_noise -n example/subway.raw -u -s 10 -r 2000 -e fant.log --explain > output.txt
+grep -q "measurement of S: G.712 filter (16 -> 8 kHz) -> P.56 voltmeter (8 kHz)" output.txt
+grep -q "noise at a SNR of 10.00 dB" output.txt
+grep -q "quantize:         overload correction -> 16 bit" output.txt
+./filter_add_noise -n example/subway.raw -u -s 10 -r 2000 -e fant.log --format float32 --explain > output.txt
+grep -q "quantize:         none, float32 outputs (overload only reported)" output.txt
+./filter_add_noise -i example/in.list -o example/out.list -n example/subway.raw -u -s 10 -r 2000 -e fant.log
+cmp example/57353_g712_sub_10db.raw test/16bits.raw
@@ -0,0 +1,21 @@
+set -e
+
+rm -f output.raw output.raw.fbank
+printf 'example/57353.raw\toutput.raw\n' > output.tsv
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --features %s.fbank
+cmp output.raw test/16bits.raw
+head -c 4 output.raw.fbank | grep -q FNTF
+# 24 byte header, 40 bins of 400 samples every 160 samples (16 kHz)
+n=$(( ($(stat -c %s output.raw) / 2 - 400) / 160 + 1 ))
+test $(stat -c %s output.raw.fbank) -eq $(( 24 + 4 * 40 * n ))
+rm -f output.raw
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --features %s.fbank --features-only --feat-params 32,16,24
+test ! -e output.raw
+test $(stat -c %s output.raw.fbank) -gt 24
+# the name of the features is not cut for long output paths
+d=output.d/$(printf '%0200d' 0)/$(printf '%0200d' 1)/$(printf '%0200d' 2)
+rm -rf output.d; mkdir -p $d
+printf 'example/57353.raw\t%s/output.raw\n' $d > output.tsv
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --features %s.fbank --features-only
+test $(stat -c %s $d/output.raw.fbank) -gt 24
+rm -rf output.d
@@ -0,0 +1,17 @@
+set -e
+
+cat example/57353.raw | ./filter_add_noise -n example/subway.raw -u -s 10 -r 2000 -e fant.log --format float32 > output.raw
+test $(stat -c %s output.raw) -eq $(( 2 * $(stat -c %s test/16bits.raw) ))
+printf 'example/57353.raw\toutput.wav\n' > output.tsv
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --format float32
+# IEEE float WAV of the same samples
+test "$(od -An -tu2 -j20 -N2 output.wav | tr -d ' ')" = 3
+cmp <(tail -c +45 output.wav) output.raw
+# speech level from the cache: the same float output
+rm -f output.cache
+printf 'example/57353.raw\toutput.raw\n' > output.tsv
+for i in 1 2; do
+	./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --format float32 --cache output.cache
+	cmp <(tail -c +45 output.wav) output.raw
+done
+grep -q "output.cache: 1 hits" fant.log
@@ -0,0 +1,6 @@
+set -e
+
+# index list without noise adding: not opened, normalization only
+printf '100\n' > output.txt
+./filter_add_noise -a output.txt -u -l -20 -e fant.log < example/57353.raw > output.raw
+test "$(wc -c < output.raw)" -eq "$(wc -c < example/57353.raw)"
@@ -0,0 +1,10 @@
+set -e
+
+make -f fant_check.make
+./fant_check -n 1
+for k in reference scalar auto; do
+	./filter_add_noise -i example/in.list -o example/out.list -n example/subway.raw -u -s 10 -r 2000 -e fant.log --kernels $k
+	cmp example/57353_g712_sub_10db.raw test/16bits.raw
+done
+grep -q "Kernels: auto (fir=" fant.log
+! ./filter_add_noise -i example/in.list -o example/out.list -n example/subway.raw -u -s 10 -r 2000 -e fant.log --kernels sse9
@@ -0,0 +1,7 @@
+set -e
+
+# 1st row draws the noise segment, 2nd row requests it explicitly
+printf 'example/57353.raw\toutput.raw\nexample/57353.raw\toutput2.raw\texample/subway.raw\t7552\t10\n' > output.tsv
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log
+cmp output.raw test/16bits.raw
+cmp output2.raw test/16bits.raw
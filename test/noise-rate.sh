@@ -0,0 +1,14 @@
+set -e
+
+# 16 kHz noise for 48 kHz data: raw with --noise-rate or WAV (rate of the header)
+./filter_add_noise -n example/subway.raw --noise-rate 16000 --rate 48000 -s 10 -r 2000 -e fant.log < example/57353.raw > output.raw
+grep -q "Noise signal resampled from 16000 Hz to 48000 Hz" fant.log
+test "$(wc -c < output.raw)" -eq "$(wc -c < example/57353.raw)"
+# WAV header of example/subway.raw (50000 samples at 16 kHz)
+(printf 'RIFF\xc4\x86\x01\x00WAVEfmt \x10\x00\x00\x00\x01\x00\x01\x00\x80\x3e\x00\x00\x00\x7d\x00\x00\x02\x00\x10\x00data\xa0\x86\x01\x00'; cat example/subway.raw) > output.wav
+./filter_add_noise -n output.wav --rate 48000 -s 10 -r 2000 -e fant.log < example/57353.raw > output2.raw
+cmp output.raw output2.raw
+# noise at the rate of the speech: not resampled
+./filter_add_noise -i example/in.list -o example/out.list -n example/subway.raw --noise-rate 16000 -u -s 10 -r 2000 -e fant.log
+cmp example/57353_g712_sub_10db.raw test/16bits.raw
+! ./filter_add_noise -n example/subway.raw --noise-rate 44100 -s 10 -r 2000 -e fant.log < example/57353.raw > output.raw
@@ -0,0 +1,16 @@
+set -e
+
+./filter_add_noise -n example/subway.raw --rate 48000 -f mirs -s 10 -r 2000 -e fant.log --explain > output.txt
+grep -q "measurement of S: downsampling 48 -> 16 kHz -> G.712 filter (16 -> 8 kHz) -> P.56 voltmeter (8 kHz)" output.txt
+grep -q "output chain:     MIRS (48 kHz) filter" output.txt
+# example/57353.raw taken as 48 kHz data: as many output samples
+./filter_add_noise -n example/subway.raw --rate 48000 -f mirs -s 10 -r 2000 -e fant.log < example/57353.raw > output.raw
+test "$(wc -c < output.raw)" -eq "$(wc -c < example/57353.raw)"
+grep -q "Processing of 48 kHz data" fant.log
+./filter_add_noise -n example/subway.raw --rate 32000 -m snr_8khz -s 10 -r 2000 -e fant.log < example/57353.raw > output.raw
+test "$(wc -c < output.raw)" -eq "$(wc -c < example/57353.raw)"
+# no G.712 filter and no 16 kHz WAV file at 48 kHz
+! ./filter_add_noise -n example/subway.raw --rate 48000 -f g712 -s 10 -r 2000 -e fant.log < example/57353.raw > output.raw
+printf 'RIFF\x22\x90\x00\x00WAVEfmt \x10\x00\x00\x00\x01\x00\x01\x00\x80\x3e\x00\x00\x00\x7d\x00\x00\x02\x00\x10\x00data\xfe\x8f\x00\x00' > output.wav
+cat example/57353.raw >> output.wav
+! ./filter_add_noise -n example/subway.raw --rate 48000 -s 10 -r 2000 -e fant.log < output.wav > output.raw
@@ -0,0 +1,11 @@
+set -e
+
+printf 'example/57353.raw\toutput.raw\nexample/missing.raw\toutput2.raw\n' > output.tsv
+rm -f output.raw
+! ./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --failures output.failed --results output.csv
+cmp output.raw test/16bits.raw
+test $(wc -l < output.csv) -eq 3
+grep '^0,"example/57353.raw","output.raw","ok",18431,' output.csv
+grep '^1,"example/missing.raw","output2.raw","cannot open speech file",0,' output.csv
+! ./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --failures output.failed --results output.jsonl
+grep '"entry": 0, "input": "example/57353.raw", "output": "output.raw", "status": "ok"' output.jsonl
@@ -0,0 +1,24 @@
+set -e
+
+# 2nd row requests the noise segment drawn for the 1st one
+printf 'example/57353.raw\toutput.raw\nexample/57353.raw\toutput2.raw\texample/subway.raw\t7552\t10\n' > output.tsv
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --prefetch 0 --journal output.journal
+cmp output.raw test/16bits.raw
+
+# interrupted after the 1st row: only the 2nd one is processed again
+head -1 output.journal > output.journal2
+mv output.journal2 output.journal
+rm output.raw output2.raw
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --prefetch 0 --journal output.journal --resume
+test ! -e output.raw
+cmp output2.raw test/16bits.raw
+test $(wc -l < output.journal) -eq 2
+
+# a missing speech file is reported, the other rows are processed
+printf 'example/missing.raw\toutput.raw\nexample/57353.raw\toutput2.raw\n' > output.tsv
+rm output2.raw
+if ./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --failures output.failed; then
+	exit 1
+fi
+grep example/missing.raw output.failed
+cmp output2.raw test/16bits.raw
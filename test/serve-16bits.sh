@@ -0,0 +1,10 @@
+set -e
+
+./filter_add_noise -n example/subway.raw -u -s 10 -r 2000 -e fant.log --serve fant.sock &
+while [ ! -S fant.sock ]; do sleep 0.1; done
+cat example/57353.raw | ./fant_client fant.sock - - start=7552 > output.raw
+cmp output.raw test/16bits.raw
+./fant_client fant.sock example/57353.raw output.raw start=7552
+cmp output.raw test/16bits.raw
+./fant_client fant.sock shutdown
+wait
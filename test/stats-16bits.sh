@@ -0,0 +1,8 @@
+set -e
+
+printf 'example/57353.raw\toutput.raw\n' > output.tsv
+rm -f output.raw
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --stats output.json
+cmp output.raw test/16bits.raw
+grep '"files": 1,' output.json
+grep '"voltmeter": {"seconds"' output.json
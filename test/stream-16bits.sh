@@ -0,0 +1,9 @@
+set -e
+
+# frame 1 draws the noise segment, frame 2 requests it with start=7552
+( printf 'FNTI\xff\x47\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00'
+  cat example/57353.raw
+  printf 'FNTI\xff\x47\x00\x00\x04\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x80\x1d\x00\x00'
+  cat example/57353.raw ) | ./filter_add_noise -n example/subway.raw -u -s 10 -r 2000 -e fant.log --stream > output.raw
+tail -c +33 output.raw | head -c 36862 | cmp - test/16bits.raw
+tail -c +36927 output.raw | cmp - test/16bits.raw
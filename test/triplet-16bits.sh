@@ -0,0 +1,30 @@
+set -e
+
+rm -f output.raw output.raw.clean output.raw.noise
+printf 'example/57353.raw\toutput.raw\n' > output.tsv
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --clean %s.clean --scaled-noise %s.noise
+cmp output.raw test/16bits.raw
+test $(stat -c %s output.raw.clean) -eq $(stat -c %s output.raw)
+test $(stat -c %s output.raw.noise) -eq $(stat -c %s output.raw)
+# clean + noise == output sample by sample
+samples() { od -An -v -td2 -w2 "$1"; }
+test "$(paste <(samples output.raw.clean) <(samples output.raw.noise) <(samples output.raw) | awk '$1 + $2 != $3' | wc -l)" -eq 0
+# noise far above a loud speech: the clipped samples of the noise are reported
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s -20 -l -3 -r 2000 -e fant.log --clean %s.clean --scaled-noise %s.noise
+n=$(paste <(samples output.raw.clean) <(samples output.raw.noise) <(samples output.raw) | awk '$1 + $2 != $3' | wc -l)
+tail -n 3 fant.log | grep -q "scaled noise of output.raw clipped at $n samples"
+# without noise the clean speech is the output
+./filter_add_noise --manifest output.tsv -u -l -26 -f p341 -e fant.log --clean %s.clean --scaled-noise %s.noise
+cmp output.raw.clean output.raw
+cmp output.raw.noise <(head -c $(stat -c %s output.raw) /dev/zero)
+! ./filter_add_noise --manifest output.tsv -u -l -26 -e fant.log --clean output.clean
+# a clean file that cannot be written fails its entry, not the run
+printf 'example/57353.raw\toutput.raw\nexample/57353.raw\toutput2.raw\n' > output.tsv
+rm -rf output.raw.clean output.journal; mkdir output.raw.clean
+if ./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log --clean %s.clean --scaled-noise %s.noise --journal output.journal --failures output.failed; then
+	exit 1
+fi
+rmdir output.raw.clean
+test "$(cut -f2 output.failed)" = output.raw
+test "$(cut -f3 output.journal)" = output2.raw
+test -e output2.raw.clean
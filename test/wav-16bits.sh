@@ -0,0 +1,23 @@
+set -e
+
+# 16 kHz WAV header of example/57353.raw (18431 samples)
+wav_header() {
+	printf 'RIFF\x22\x90\x00\x00WAVEfmt \x10\x00\x00\x00\x01\x00\x01\x00\x80\x3e\x00\x00\x00\x7d\x00\x00\x02\x00\x10\x00data\xfe\x8f\x00\x00'
+}
+(wav_header; cat example/57353.raw) > output.wav
+./filter_add_noise -n example/subway.raw -u -s 10 -r 2000 -e fant.log < output.wav > output.raw
+cmp output.raw test/16bits.raw
+printf 'output.wav\toutput2.wav\n' > output.tsv
+./filter_add_noise --manifest output.tsv -n example/subway.raw -u -s 10 -r 2000 -e fant.log
+cmp output2.wav <(wav_header; cat test/16bits.raw)
+# big endian raw speech and noise
+dd if=example/subway.raw of=output.raw.noise conv=swab status=none
+dd if=example/57353.raw conv=swab status=none | ./filter_add_noise --big-endian -n output.raw.noise -u -s 10 -r 2000 -e fant.log > output.raw
+cmp output.raw test/16bits.raw
+# ... also read ahead in a batch run
+dd if=example/57353.raw of=output.raw.speech conv=swab status=none
+printf 'output.raw.speech\toutput.raw\n' > output.tsv
+./filter_add_noise --manifest output.tsv --big-endian -n output.raw.noise -u -s 10 -r 2000 -e fant.log
+cmp output.raw test/16bits.raw
+# 16 kHz file without -u
+! ./filter_add_noise -n example/subway.raw -s 10 -r 2000 -e fant.log < output.wav > output.raw